@@ -28,6 +28,9 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <atomic>
+
+#include "flatbuffers/hash.h"
 
 #if __cplusplus <= 199711L && \
     (!defined(_MSC_VER) || _MSC_VER < 1600) && \
@@ -70,6 +73,14 @@
   #define FLATBUFFERS_FINAL_CLASS
 #endif
 
+// Storage class for variables that get a separate instance in each thread.
+// Limited to plain old data, since that's all __thread supports.
+#if defined(_MSC_VER)
+  #define FLATBUFFERS_THREAD_LOCAL __declspec(thread)
+#else
+  #define FLATBUFFERS_THREAD_LOCAL __thread
+#endif
+
 namespace flatbuffers {
 
 // Our default offset / size type, 32bit on purpose on 64bit systems.
@@ -335,6 +346,7 @@ template<typename T> static inline size_t VectorLength(const Vector<T> *v) {
 
 struct String : public Vector<char> {
   const char *c_str() const { return reinterpret_cast<const char *>(Data()); }
+  std::string str() const { return std::string(c_str(), Length()); }
 
   bool operator <(const String &o) const {
     return strcmp(c_str(), o.c_str()) < 0;
@@ -348,11 +360,118 @@ class simple_allocator {
   virtual ~simple_allocator() {}
   virtual uint8_t *allocate(size_t size) const { return new uint8_t[size]; }
   virtual void deallocate(uint8_t *p) const { delete[] p; }
+
+  // The allocator used by a FlatBufferBuilder if none is specified. It has no
+  // state, so all builders share this one instance.
+  static const simple_allocator &default_instance() {
+    static simple_allocator instance;
+    return instance;
+  }
+};
+
+// An allocator that recycles memory instead of returning it to the heap.
+// Freed blocks are kept on per-thread free lists, bucketed by power of 2 size
+// class, so once a thread has built a few buffers, building more of a similar
+// size (including growing them, and freeing buffers obtained through
+// ReleaseBufferPointer) doesn't make any heap calls.
+// Blocks may be freed by a different thread than the one that allocated them,
+// they then simply end up on the free lists of the freeing thread.
+class pool_allocator : public simple_allocator {
+ public:
+  // Blocks bigger than 2^kMaxSizeClass bytes always come from the heap.
+  static const size_t kMaxSizeClass = 24;
+  // Maximum number of blocks kept per size class, per thread.
+  static const size_t kMaxFreeBlocks = 16;
+
+  virtual uint8_t *allocate(size_t size) const {
+    auto size_class = SizeClass(size);
+    if (size_class <= kMaxSizeClass) {
+      auto &list = free_lists()[size_class];
+      if (list.head) {
+        auto block = list.head;
+        list.head = *reinterpret_cast<uint8_t **>(block + kHeaderSize);
+        list.count--;
+        return block + kHeaderSize;
+      }
+      size = static_cast<size_t>(1) << size_class;
+    }
+    auto block = new uint8_t[kHeaderSize + size];
+    *reinterpret_cast<size_t *>(block) = size_class;
+    return block + kHeaderSize;
+  }
+
+  virtual void deallocate(uint8_t *p) const {
+    if (!p) return;
+    auto block = p - kHeaderSize;
+    auto size_class = *reinterpret_cast<size_t *>(block);
+    if (size_class <= kMaxSizeClass) {
+      auto &list = free_lists()[size_class];
+      if (list.count < kMaxFreeBlocks) {
+        *reinterpret_cast<uint8_t **>(p) = list.head;
+        list.head = block;
+        list.count++;
+        return;
+      }
+    }
+    delete[] block;
+  }
+
+  // Return all blocks cached by the calling thread to the heap, e.g. before
+  // the thread exits (they're not freed automatically).
+  static void trim() {
+    auto lists = free_lists();
+    for (size_t i = 0; i <= kMaxSizeClass; i++) {
+      while (lists[i].head) {
+        auto block = lists[i].head;
+        lists[i].head = *reinterpret_cast<uint8_t **>(block + kHeaderSize);
+        delete[] block;
+      }
+      lists[i].count = 0;
+    }
+  }
+
+ private:
+  // Each block starts with its size class, sized such that the memory we hand
+  // out stays aligned to the largest scalar.
+  static const size_t kHeaderSize = sizeof(largest_scalar_t);
+  // Smallest size class, large enough to hold the free list link.
+  static const size_t kMinSizeClass = 4;
+
+  struct FreeList {
+    uint8_t *head;
+    size_t count;
+  };
+
+  static FreeList *free_lists() {
+    static FLATBUFFERS_THREAD_LOCAL FreeList lists[kMaxSizeClass + 1];
+    return lists;
+  }
+
+  static size_t SizeClass(size_t size) {
+    auto size_class = kMinSizeClass;
+    while ((static_cast<size_t>(1) << size_class) < size &&
+           size_class <= kMaxSizeClass) {
+      size_class++;
+    }
+    return size_class;
+  }
+};
+
+// A contiguous piece of a serialized buffer, see
+// FlatBufferBuilder::GetBufferSlices(). This has the same layout as POSIX
+// struct iovec, so an array of these can be passed to writev() as-is.
+struct BufferSlice {
+  const void *data;
+  size_t size;
 };
 
 // This is a minimal replication of std::vector<uint8_t> functionality,
 // except growing from higher to lower addresses. i.e push_back() inserts data
 // in the lowest address in the vector.
+// Optionally, instead of reallocating to grow, it can start a new chunk of
+// memory, leaving everything written so far in place. Offsets (as used by
+// data_at()) keep counting from the end of the oldest chunk, but the data
+// is then only contiguous within each chunk.
 class vector_downward {
  public:
   explicit vector_downward(size_t initial_size,
@@ -360,27 +479,35 @@ class vector_downward {
     : reserved_(initial_size),
       buf_(allocator.allocate(reserved_)),
       cur_(buf_ + reserved_),
+      slack_(0),
+      sealed_(0),
+      chunk_size_(0),
       allocator_(allocator) {
     assert((initial_size & (sizeof(largest_scalar_t) - 1)) == 0);
   }
 
   ~vector_downward() {
+    free_chunks();
     if (buf_)
       allocator_.deallocate(buf_);
   }
 
   void clear() {
+    free_chunks();
     if (buf_ == nullptr)
       buf_ = allocator_.allocate(reserved_);
 
+    slack_ = 0;
     cur_ = buf_ + reserved_;
   }
 
   // Relinquish the pointer to the caller.
+  // The allocator used must outlive the returned pointer.
   unique_ptr_t release() {
+    assert(chunks_.empty());  // Not possible when spread over chunks.
     // Actually deallocate from the start of the allocated memory.
     std::function<void(uint8_t *)> deleter(
-      std::bind(&simple_allocator::deallocate, allocator_, buf_));
+      std::bind(&simple_allocator::deallocate, &allocator_, buf_));
 
     // Point to the desired offset.
     unique_ptr_t retval(data(), deleter);
@@ -392,20 +519,25 @@ class vector_downward {
     return retval;
   }
 
+  // Grow by starting new chunks of (at least) this size rather than
+  // reallocating, or 0 to always stay contiguous.
+  void set_chunk_size(size_t chunk_size) {
+    assert(chunks_.empty());
+    chunk_size_ = (chunk_size + sizeof(largest_scalar_t) - 1) &
+                  ~(sizeof(largest_scalar_t) - 1);
+  }
+
   size_t growth_policy(size_t bytes) {
     return (bytes / 2) & ~(sizeof(largest_scalar_t) - 1);
   }
 
   uint8_t *make_space(size_t len) {
     if (len > static_cast<size_t>(cur_ - buf_)) {
-      auto old_size = size();
-      reserved_ += std::max(len, growth_policy(reserved_));
-      auto new_buf = allocator_.allocate(reserved_);
-      auto new_cur = new_buf + reserved_ - old_size;
-      memcpy(new_cur, cur_, old_size);
-      cur_ = new_cur;
-      allocator_.deallocate(buf_);
-      buf_ = new_buf;
+      if (chunk_size_) {
+        new_chunk(len);
+      } else {
+        reallocate(reserved_ + std::max(len, growth_policy(reserved_)));
+      }
     }
     cur_ -= len;
     // Beyond this, signed offsets may not have enough range:
@@ -414,9 +546,30 @@ class vector_downward {
     return cur_;
   }
 
+  // Make sure the next "len" bytes written end up contiguous in memory,
+  // for data that we need to read back while building. A no-op unless
+  // growing by chunks.
+  void ensure_space(size_t len) {
+    if (chunk_size_ && len > static_cast<size_t>(cur_ - buf_))
+      new_chunk(len);
+  }
+
+  // Make room for the next "len" bytes in one go, so writing them never
+  // grows the buffer.
+  void reserve(size_t len) {
+    auto available = static_cast<size_t>(cur_ - buf_);
+    if (len <= available) return;
+    if (chunk_size_) {
+      new_chunk(len);
+    } else {
+      reallocate(reserved_ + ((len - available + sizeof(largest_scalar_t) - 1) &
+                              ~(sizeof(largest_scalar_t) - 1)));
+    }
+  }
+
   uoffset_t size() const {
     assert(cur_ != nullptr && buf_ != nullptr);
-    return static_cast<uoffset_t>(reserved_ - (cur_ - buf_));
+    return static_cast<uoffset_t>(sealed_ + (chunk_end() - cur_));
   }
 
   uint8_t *data() const {
@@ -424,7 +577,29 @@ class vector_downward {
     return cur_;
   }
 
-  uint8_t *data_at(size_t offset) { return buf_ + reserved_ - offset; }
+  uint8_t *data_at(size_t offset) const {
+    if (offset > sealed_ || chunks_.empty())
+      return chunk_end() - (offset - sealed_);
+    // Find the last chunk that starts below this offset.
+    auto it = std::lower_bound(chunks_.begin(), chunks_.end(), offset,
+      [](const chunk &c, size_t off) { return c.base < off; });
+    --it;
+    return it->end - (offset - it->base);
+  }
+
+  // The number of separate pieces of memory the data is spread over.
+  size_t num_slices() const { return chunks_.size() + 1; }
+
+  // Slices in memory order, i.e. starting with the most recently written.
+  void get_slices(BufferSlice *slices) const {
+    slices->data = cur_;
+    slices->size = chunk_end() - cur_;
+    for (auto it = chunks_.rbegin(); it != chunks_.rend(); ++it) {
+      ++slices;
+      slices->data = it->cur;
+      slices->size = it->end - it->cur;
+    }
+  }
 
   // push() & fill() are most frequently called with small byte counts (<= 4),
   // which is why we're using loops rather than calling memcpy/memset.
@@ -438,19 +613,143 @@ class vector_downward {
     for (size_t i = 0; i < zero_pad_bytes; i++) dest[i] = 0;
   }
 
-  void pop(size_t bytes_to_remove) { cur_ += bytes_to_remove; }
+  void pop(size_t bytes_to_remove) {
+    cur_ += bytes_to_remove;
+    assert(cur_ <= chunk_end());  // Can't pop across chunks.
+  }
 
  private:
   // You shouldn't really be copying instances of this class.
   vector_downward(const vector_downward &);
   vector_downward &operator=(const vector_downward &);
 
+  // A chunk we've stopped writing to.
+  struct chunk {
+    uint8_t *buf;  // As allocated.
+    uint8_t *cur;  // First byte in use.
+    uint8_t *end;  // One past the last byte in use.
+    size_t base;   // Bytes in use in all older chunks.
+  };
+
+  uint8_t *chunk_end() const { return buf_ + reserved_ - slack_; }
+
+  // Move the data to a single larger allocation of "new_reserved" bytes.
+  void reallocate(size_t new_reserved) {
+    auto old_size = size();
+    reserved_ = new_reserved;
+    auto new_buf = allocator_.allocate(reserved_);
+    auto new_cur = new_buf + reserved_ - old_size;
+    memcpy(new_cur, cur_, old_size);
+    cur_ = new_cur;
+    allocator_.deallocate(buf_);
+    buf_ = new_buf;
+  }
+
+  void new_chunk(size_t len) {
+    if (cur_ != chunk_end()) {
+      chunk c = { buf_, cur_, chunk_end(), sealed_ };
+      chunks_.push_back(c);
+      sealed_ = size();
+    } else {
+      allocator_.deallocate(buf_);  // Nothing in it, don't keep it around.
+    }
+    // Alignment is relative to the end of the buffer, so leave as many
+    // bytes unused at the end of this chunk as the older ones are off from
+    // being a multiple of the largest scalar.
+    slack_ = sealed_ & (sizeof(largest_scalar_t) - 1);
+    reserved_ = std::max(chunk_size_,
+                         (len + slack_ + sizeof(largest_scalar_t) - 1) &
+                           ~(sizeof(largest_scalar_t) - 1));
+    buf_ = allocator_.allocate(reserved_);
+    cur_ = chunk_end();
+  }
+
+  void free_chunks() {
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it)
+      allocator_.deallocate(it->buf);
+    chunks_.clear();
+    sealed_ = 0;
+  }
+
   size_t reserved_;
   uint8_t *buf_;
   uint8_t *cur_;  // Points at location between empty (below) and used (above).
+  size_t slack_;  // Unused bytes at the end of buf_.
+  std::vector<chunk> chunks_;  // Older chunks, oldest first.
+  size_t sealed_;  // Bytes in use in chunks_.
+  size_t chunk_size_;
   const simple_allocator &allocator_;
 };
 
+// An open addressing hash set of offsets into a vector_downward, used to find
+// previously serialized data by content. Only the hash of each element is
+// stored here, comparing the actual bytes is left to the caller, since they
+// live in the buffer.
+class offset_hash_set {
+ public:
+  offset_hash_set() : size_(0) {}
+
+  // Keeps the allocated slots around for the next buffer.
+  void clear() {
+    slots_.clear();
+    size_ = 0;
+  }
+
+  // Returns the first element with this hash for which equal(offset) is true,
+  // or 0 if there's none.
+  template<typename F> uoffset_t find(uint32_t hash, F equal) const {
+    if (slots_.empty()) return 0;
+    auto mask = slots_.size() - 1;
+    for (auto i = hash & mask; slots_[i].off; i = (i + 1) & mask) {
+      if (slots_[i].hash == hash && equal(slots_[i].off))
+        return slots_[i].off;
+    }
+    return 0;
+  }
+
+  void insert(uint32_t hash, uoffset_t off) {
+    assert(off);  // 0 marks an empty slot.
+    // Keep the load factor under 3/4, so probe sequences stay short.
+    if ((size_ + 1) * 4 > slots_.size() * 3) grow();
+    place(hash, off);
+    size_++;
+  }
+
+  // FNV-1a, which is plenty for the short keys (vtables, strings) we store.
+  static uint32_t hash_bytes(const uint8_t *bytes, size_t len) {
+    return HashFnv1a<uint32_t>(reinterpret_cast<const char *>(bytes), len);
+  }
+
+ private:
+  struct Slot {
+    uoffset_t off;
+    uint32_t hash;
+  };
+
+  void place(uint32_t hash, uoffset_t off) {
+    auto mask = slots_.size() - 1;
+    auto i = hash & mask;
+    while (slots_[i].off) i = (i + 1) & mask;
+    slots_[i].off = off;
+    slots_[i].hash = hash;
+  }
+
+  void grow() {
+    if (slots_.empty()) {
+      slots_.resize(16);
+      return;
+    }
+    std::vector<Slot> old_slots(slots_.size() * 2);
+    old_slots.swap(slots_);
+    for (auto it = old_slots.begin(); it != old_slots.end(); ++it) {
+      if (it->off) place(it->hash, it->off);
+    }
+  }
+
+  std::vector<Slot> slots_;  // Size is always 0 or a power of 2.
+  size_t size_;
+};
+
 // Converts a Field ID to a virtual table offset.
 inline voffset_t FieldIndexToOffset(voffset_t field_id) {
   // Should correspond to what EndTable() below builds up.
@@ -465,6 +764,28 @@ inline size_t PaddingBytes(size_t buf_size, size_t scalar_size) {
   return ((~buf_size) + 1) & (scalar_size - 1);
 }
 
+// Upper bounds on the bytes a FlatBufferBuilder uses to store a string of
+// "len" bytes, or a vector of "len" elements of "elem_size" bytes each,
+// aligned to "alignment", including any padding in front of them.
+// Used by the generated MaxSerializedSize() functions, to size buffers up
+// front with FlatBufferBuilder::Reserve().
+inline size_t MaxStringSize(size_t len) {
+  return (sizeof(uoffset_t) - 1) + sizeof(uoffset_t) + len + 1;
+}
+
+inline size_t MaxVectorSize(size_t len, size_t elem_size,
+                            size_t alignment = 1) {
+  return (std::max(alignment, sizeof(uoffset_t)) - 1) + sizeof(uoffset_t) +
+         len * elem_size;
+}
+
+// Upper bound on the bytes Finish() or FinishSizePrefixed() add to a buffer
+// in which nothing is aligned to more than "alignment".
+inline size_t MaxFinishSize(size_t alignment = sizeof(largest_scalar_t)) {
+  return (std::max(alignment, sizeof(largest_scalar_t)) - 1) +
+         2 * sizeof(uoffset_t) + 4 /* file identifier */;
+}
+
 // Helper class to hold data needed in creation of a flat buffer.
 // To serialize data, you typically call one of the Create*() functions in
 // the generated code, which in turn call a sequence of StartTable/PushElement/
@@ -475,10 +796,11 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
  public:
   explicit FlatBufferBuilder(uoffset_t initial_size = 1024,
                              const simple_allocator *allocator = nullptr)
-      : buf_(initial_size, allocator ? *allocator : default_allocator),
-        minalign_(1), force_defaults_(false) {
+      : buf_(initial_size,
+             allocator ? *allocator : simple_allocator::default_instance()),
+        minalign_(1), force_defaults_(false), intern_strings_(false),
+        chunked_(false) {
     offsetbuf_.reserve(16);  // Avoid first few reallocs.
-    vtables_.reserve(16);
     EndianCheck();
   }
 
@@ -488,6 +810,7 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
     buf_.clear();
     offsetbuf_.clear();
     vtables_.clear();
+    strings_.clear();
     minalign_ = 1;
   }
 
@@ -495,14 +818,59 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   uoffset_t GetSize() const { return buf_.size(); }
 
   // Get the serialized buffer (after you call Finish()).
-  uint8_t *GetBufferPointer() const { return buf_.data(); }
+  // With ChunkedStorage(), only valid if the buffer fit in a single chunk,
+  // use GetBufferSlices() instead.
+  uint8_t *GetBufferPointer() const {
+    assert(buf_.num_slices() == 1);
+    return buf_.data();
+  }
+
+  // Get the serialized buffer as a list of contiguous pieces of memory, in
+  // order. This is a single slice unless ChunkedStorage() is in use.
+  // The slices stay valid until the builder is modified or destroyed.
+  std::vector<BufferSlice> GetBufferSlices() const {
+    std::vector<BufferSlice> slices(buf_.num_slices());
+    buf_.get_slices(slices.data());
+    return slices;
+  }
+
+  // Copy the serialized buffer to "dest", which must have room for GetSize()
+  // bytes. This is how to get contiguous data out of chunked storage.
+  void CopyBuffer(uint8_t *dest) const {
+    auto slices = GetBufferSlices();
+    for (auto it = slices.begin(); it != slices.end(); ++it) {
+      memcpy(dest, it->data, it->size);
+      dest += it->size;
+    }
+  }
 
   // Get the released pointer to the serialized buffer.
   // Don't attempt to use this FlatBufferBuilder afterwards!
+  // Not available if the buffer got spread over multiple chunks.
   unique_ptr_t ReleaseBufferPointer() { return buf_.release(); }
 
   void ForceDefaults(bool fd) { force_defaults_ = fd; }
 
+  // Rather than reallocating (and copying) the buffer when it runs out of
+  // space, continue in a new chunk of memory of (at least) "chunk_size"
+  // bytes, so building very large buffers never copies. The result is then
+  // read with GetBufferSlices() or CopyBuffer().
+  // Must be called before anything is written, 0 turns it back off.
+  // CreateVectorOfSortedTables() can't be used in this mode.
+  void ChunkedStorage(size_t chunk_size) {
+    assert(!GetSize());
+    buf_.set_chunk_size(chunk_size);
+    chunked_ = chunk_size != 0;
+  }
+
+  // Make room for "size" more bytes, so writing them never reallocates (or,
+  // with ChunkedStorage(), starts a new chunk). Use with the generated
+  // MaxSerializedSize() functions to allocate a buffer only once.
+  void Reserve(size_t size) { buf_.reserve(size); }
+
+  // Make every CreateString call behave like CreateSharedString.
+  void InternStrings(bool is) { intern_strings_ = is; }
+
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
   void Align(size_t elem_size) {
@@ -601,6 +969,8 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
     // Write a vtable, which consists entirely of voffset_t elements.
     // It starts with the number of offsets, followed by a type id, followed
     // by the offsets themselves. In reverse:
+    // We read it back below, so it must not straddle chunks.
+    buf_.ensure_space((numfields + 2) * sizeof(voffset_t));
     buf_.fill(numfields * sizeof(voffset_t));
     auto table_object_size = vtableoffsetloc - start;
     assert(table_object_size < 0x10000);  // Vtable use 16bit offsets.
@@ -616,22 +986,22 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
       WriteScalar<voffset_t>(buf_.data() + field_location->id, pos);
     }
     offsetbuf_.clear();
-    auto vt1 = reinterpret_cast<voffset_t *>(buf_.data());
+    auto vt1 = buf_.data();
     auto vt1_size = ReadScalar<voffset_t>(vt1);
-    auto vt_use = GetSize();
+    auto vt1_hash = offset_hash_set::hash_bytes(vt1, vt1_size);
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
-    for (auto it = vtables_.begin(); it != vtables_.end(); ++it) {
-      auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
-      auto vt2_size = *vt2;
-      if (vt1_size != vt2_size || memcmp(vt2, vt1, vt1_size)) continue;
-      vt_use = *it;
+    auto vt_use = vtables_.find(vt1_hash, [&](uoffset_t vt2_off) -> bool {
+      auto vt2 = buf_.data_at(vt2_off);
+      return ReadScalar<voffset_t>(vt2) == vt1_size &&
+             !memcmp(vt2, vt1, vt1_size);
+    });
+    if (vt_use) {
       buf_.pop(GetSize() - vtableoffsetloc);
-      break;
-    }
-    // If this is a new vtable, remember it.
-    if (vt_use == GetSize()) {
-      vtables_.push_back(vt_use);
+    } else {
+      // This is a new vtable, remember it.
+      vt_use = GetSize();
+      vtables_.insert(vt1_hash, vt_use);
     }
     // Fill the vtable offset we created above.
     // The offset points from the beginning of the object to where the
@@ -648,7 +1018,9 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   // just been constructed.
   template<typename T> void Required(Offset<T> table, voffset_t field) {
     auto table_ptr = buf_.data_at(table.o);
-    auto vtable_ptr = table_ptr - ReadScalar<soffset_t>(table_ptr);
+    // Look up the vtable by offset, it may be in a different chunk.
+    auto vtable_ptr = buf_.data_at(table.o +
+                                   ReadScalar<soffset_t>(table_ptr));
     bool ok = ReadScalar<voffset_t>(vtable_ptr + field) != 0;
     // If this fails, the caller will show what field needs to be set.
     assert(ok);
@@ -676,12 +1048,9 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
 
   // Functions to store strings, which are allowed to contain any binary data.
   Offset<String> CreateString(const char *str, size_t len) {
+    if (intern_strings_) return CreateSharedString(str, len);
     NotNested();
-    PreAlign<uoffset_t>(len + 1);  // Always 0-terminated.
-    buf_.fill(1);
-    PushBytes(reinterpret_cast<const uint8_t *>(str), len);
-    PushElement(static_cast<uoffset_t>(len));
-    return Offset<String>(GetSize());
+    return Offset<String>(WriteString(str, len));
   }
 
   Offset<String> CreateString(const char *str) {
@@ -692,6 +1061,32 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
     return CreateString(str.c_str(), str.length());
   }
 
+  // Like CreateString, but if a string with the same contents has been stored
+  // with this function before, returns the offset of that one instead of
+  // storing a copy. Strings are still allowed to contain any binary data.
+  Offset<String> CreateSharedString(const char *str, size_t len) {
+    NotNested();
+    auto hash = offset_hash_set::hash_bytes(
+                  reinterpret_cast<const uint8_t *>(str), len);
+    auto off = strings_.find(hash, [&](uoffset_t str2_off) -> bool {
+      auto str2 = reinterpret_cast<const String *>(buf_.data_at(str2_off));
+      return str2->size() == len && !memcmp(str2->c_str(), str, len);
+    });
+    if (!off) {
+      off = WriteString(str, len);
+      strings_.insert(hash, off);
+    }
+    return Offset<String>(off);
+  }
+
+  Offset<String> CreateSharedString(const char *str) {
+    return CreateSharedString(str, strlen(str));
+  }
+
+  Offset<String> CreateSharedString(const std::string &str) {
+    return CreateSharedString(str.c_str(), str.length());
+  }
+
   uoffset_t EndVector(size_t len) {
     return PushElement(static_cast<uoffset_t>(len));
   }
@@ -708,9 +1103,8 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   template<typename T> Offset<Vector<T>> CreateVector(const T *v, size_t len) {
     NotNested();
     StartVector(len, sizeof(T));
-    for (auto i = len; i > 0; ) {
-      PushElement(v[--i]);
-    }
+    // Scalars can be copied in one go, offsets need to be adjusted one by one.
+    PushElements(v, len, std::is_scalar<T>());
     return Offset<Vector<T>>(EndVector(len));
   }
 
@@ -733,6 +1127,8 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
 
   template<typename T> Offset<Vector<Offset<T>>> CreateVectorOfSortedTables(
                                                      Offset<T> *v, size_t len) {
+    // Comparing keys follows offsets, which needs a contiguous buffer.
+    assert(!chunked_);
     std::sort(v, v + len,
       [this](const Offset<T> &a, const Offset<T> &b) -> bool {
         auto table_a = reinterpret_cast<T *>(buf_.data_at(a.o));
@@ -771,15 +1167,17 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   // FlatBuffers file header.
   template<typename T> void Finish(Offset<T> root,
                                    const char *file_identifier = nullptr) {
-    // This will cause the whole buffer to be aligned.
-    PreAlign(sizeof(uoffset_t) + (file_identifier ? kFileIdentifierLength : 0),
-             minalign_);
-    if (file_identifier) {
-      assert(strlen(file_identifier) == kFileIdentifierLength);
-      buf_.push(reinterpret_cast<const uint8_t *>(file_identifier),
-                kFileIdentifierLength);
-    }
-    PushElement(ReferTo(root.o));  // Location of root.
+    Finish(root.o, file_identifier, false);
+  }
+
+  // Like Finish, but additionally prefixes the buffer with its size (not
+  // counting the prefix itself), such that buffers can be stored back to
+  // back in a file or stream, and read with SizePrefixedBufferIterator.
+  // The total size is padded to a multiple of the largest scalar, so all
+  // buffers in such a stream stay aligned.
+  template<typename T> void FinishSizePrefixed(Offset<T> root,
+                                     const char *file_identifier = nullptr) {
+    Finish(root.o, file_identifier, true);
   }
 
  private:
@@ -792,18 +1190,74 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
     voffset_t id;
   };
 
-  simple_allocator default_allocator;
+  template<typename T> void PushElements(const T *v, size_t len,
+                                         std::true_type /*is_scalar*/) {
+    if (!len) return;
+    Align(sizeof(T));  // No padding after StartVector, but sets minalign_.
+    auto dest = buf_.make_space(len * sizeof(T));
+    #if FLATBUFFERS_LITTLEENDIAN
+      memcpy(dest, v, len * sizeof(T));
+    #else
+      // A bswap per element already runs at close to memory speed; a byte
+      // shuffling loop that compilers can vectorize was no faster at -O3,
+      // and 3x slower at -O2.
+      for (size_t i = 0; i < len; i++)
+        WriteScalar(dest + i * sizeof(T), v[i]);
+    #endif
+  }
+
+  template<typename T> void PushElements(const T *v, size_t len,
+                                         std::false_type /*is_scalar*/) {
+    for (auto i = len; i > 0; ) {
+      PushElement(v[--i]);
+    }
+  }
+
+  void Finish(uoffset_t root, const char *file_identifier, bool size_prefix) {
+    auto alignment = size_prefix
+      ? std::max(minalign_, sizeof(largest_scalar_t))
+      : minalign_;
+    // This will cause the whole buffer to be aligned.
+    PreAlign(sizeof(uoffset_t) * (size_prefix ? 2 : 1) +
+               (file_identifier ? kFileIdentifierLength : 0),
+             alignment);
+    if (file_identifier) {
+      assert(strlen(file_identifier) == kFileIdentifierLength);
+      buf_.push(reinterpret_cast<const uint8_t *>(file_identifier),
+                kFileIdentifierLength);
+    }
+    PushElement(ReferTo(root));  // Location of root.
+    if (size_prefix) PushElement(GetSize());
+  }
+
+  uoffset_t WriteString(const char *str, size_t len) {
+    // Keep it in one piece, for CreateSharedString to compare against.
+    buf_.ensure_space(len + 1 + 2 * sizeof(uoffset_t));
+    PreAlign<uoffset_t>(len + 1);  // Always 0-terminated.
+    buf_.fill(1);
+    PushBytes(reinterpret_cast<const uint8_t *>(str), len);
+    PushElement(static_cast<uoffset_t>(len));
+    return GetSize();
+  }
 
   vector_downward buf_;
 
   // Accumulating offsets of table members while it is being built.
   std::vector<FieldLoc> offsetbuf_;
 
-  std::vector<uoffset_t> vtables_;  // todo: Could make this into a map?
+  // Locations of all vtables written so far, indexed by their contents.
+  offset_hash_set vtables_;
+
+  // Locations of strings created through CreateSharedString.
+  offset_hash_set strings_;
 
   size_t minalign_;
 
   bool force_defaults_;  // Serialize values equal to their defaults anyway.
+
+  bool intern_strings_;  // Route all CreateString calls to CreateSharedString.
+
+  bool chunked_;  // Grow by adding chunks, see ChunkedStorage().
 };
 
 // Helper to get a typed pointer to the root object contained in the buffer.
@@ -819,13 +1273,73 @@ inline bool BufferHasIdentifier(const void *buf, const char *identifier) {
                  identifier, FlatBufferBuilder::kFileIdentifierLength) == 0;
 }
 
+// Same as the above, for buffers made with FinishSizePrefixed().
+template<typename T> const T *GetSizePrefixedRoot(const void *buf) {
+  return GetRoot<T>(reinterpret_cast<const uint8_t *>(buf) + sizeof(uoffset_t));
+}
+
+// The size of a buffer made with FinishSizePrefixed(), not counting the
+// prefix itself.
+inline uoffset_t GetPrefixedSize(const void *buf) {
+  return ReadScalar<uoffset_t>(buf);
+}
+
+// Walks a sequence of buffers made with FinishSizePrefixed() stored back to
+// back, e.g. in a memory mapped file, without copying them. Use like:
+//   SizePrefixedBufferIterator it(data, size);
+//   while (it.Next()) { auto monster = GetMonster(it.GetBuffer()); ... }
+// Buffers can be skipped without looking at their contents, and are not
+// verified: use a Verifier on GetBuffer() / GetSize() for that.
+class SizePrefixedBufferIterator FLATBUFFERS_FINAL_CLASS {
+ public:
+  SizePrefixedBufferIterator(const void *buf, size_t buf_len)
+    : cur_(nullptr), size_(0),
+      next_(reinterpret_cast<const uint8_t *>(buf)), end_(next_ + buf_len),
+      start_(next_) {}
+
+  // Move to the next buffer. Returns false if there is none, or if it
+  // doesn't entirely fit in the data given, e.g. when the stream got
+  // truncated or more data is still to arrive.
+  bool Next() {
+    auto left = static_cast<size_t>(end_ - next_);
+    if (left < sizeof(uoffset_t)) return false;
+    auto size = GetPrefixedSize(next_);
+    if (size > left - sizeof(uoffset_t)) return false;
+    cur_ = next_ + sizeof(uoffset_t);
+    size_ = size;
+    next_ = cur_ + size;
+    return true;
+  }
+
+  // The current buffer (without its size prefix), and its size.
+  const uint8_t *GetBuffer() const { return cur_; }
+  uoffset_t GetSize() const { return size_; }
+
+  // How many bytes of the stream have been walked, including the current
+  // buffer. Once Next() returns false, anything past this is left over.
+  size_t GetOffset() const { return static_cast<size_t>(next_ - start_); }
+
+ private:
+  const uint8_t *cur_;
+  uoffset_t size_;
+  const uint8_t *next_;
+  const uint8_t *end_;
+  const uint8_t *start_;
+};
+
+// A distinct address per type T, to tell table types apart without RTTI.
+template<typename T> struct TypeTag { static const char tag; };
+template<typename T> const char TypeTag<T>::tag = 0;
+
 // Helper class to verify the integrity of a FlatBuffer
 class Verifier FLATBUFFERS_FINAL_CLASS {
  public:
   Verifier(const uint8_t *buf, size_t buf_len, size_t _max_depth = 64,
            size_t _max_tables = 1000000)
     : buf_(buf), end_(buf + buf_len), depth_(0), max_depth_(_max_depth),
-      num_tables_(0), max_tables_(_max_tables)
+      num_tables_(0), max_tables_(_max_tables), last_vtable_(nullptr),
+      last_field_sizes_(nullptr), max_tasks_(1), min_tables_per_task_(1),
+      memoize_tables_(false)
     {}
 
   // Central location where any verification failures register.
@@ -848,7 +1362,9 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
   // Verify a pointer (may be NULL) of a table type.
   template<typename T> bool VerifyTable(const T *table) {
-    return !table || table->Verify(*this);
+    return !table ||
+           (memoize_tables_ && Visited(table, &TypeTag<T>::tag)) ||
+           table->Verify(*this);
   }
 
   // Verify a pointer (may be NULL) of any vector type.
@@ -894,13 +1410,111 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   // Special case for table contents, after the above has been called.
   template<typename T> bool VerifyVectorOfTables(const Vector<Offset<T>> *vec) {
     if (vec) {
+      if (max_tasks_ > 1 && !memoize_tables_ &&
+          vec->size() >= 2 * min_tables_per_task_)
+        return VerifyTablesInParallel(vec);
       for (uoffset_t i = 0; i < vec->size(); i++) {
-        if (!vec->Get(i)->Verify(*this)) return false;
+        if (!VerifyTable(vec->Get(i))) return false;
       }
     }
     return true;
   }
 
+  // Runs task(0) .. task(num_tasks - 1), possibly concurrently, and returns
+  // once all of them have finished. See RunOnThreads() in util.h.
+  typedef std::function<void(size_t num_tasks,
+                             const std::function<void(size_t)> &task)>
+    Executor;
+
+  // Verify vectors of at least 2 * min_tables_per_task tables as up to
+  // max_tasks tasks handed to executor, each taking a contiguous range of
+  // the vector. Nested vectors are verified by whichever task reaches them.
+  // The executor is called per vector, so this only pays off for large
+  // buffers. This header starts no threads itself.
+  void SetExecutor(const Executor &executor, size_t max_tasks,
+                   size_t min_tables_per_task = 4096) {
+    executor_ = executor;
+    max_tasks_ = executor ? max_tasks : 1;
+    min_tables_per_task_ = min_tables_per_task ? min_tables_per_task : 1;
+  }
+
+  // Verify each table only once, however many offsets point to it, and
+  // count it once against max_tables. Buffers may legitimately share
+  // tables (a DAG), which otherwise costs time exponential in the depth of
+  // the sharing, and can exceed max_tables for a small buffer.
+  // This keeps a bitmap with a bit per 4 bytes of buffer for each table type
+  // encountered, so memory use grows with the buffer size. A shared table is
+  // only checked against max_depth along the first path that reaches it.
+  // Tables are verified on one thread in this mode, regardless of
+  // SetExecutor.
+  void SetMemoizeTables(bool memoize_tables) {
+    memoize_tables_ = memoize_tables;
+    visited_.clear();
+  }
+
+  // Returns whether obj was seen before as a table of the given type, and
+  // marks it seen. Tables are 4 byte aligned, so other positions are never
+  // marked, and get verified (and rejected) as normal.
+  bool Visited(const void *obj, const void *type) {
+    auto p = reinterpret_cast<const uint8_t *>(obj);
+    if (p < buf_ || p >= end_ || (p - buf_) % sizeof(uoffset_t)) return false;
+    auto bit = static_cast<size_t>(p - buf_) / sizeof(uoffset_t);
+    auto &bits = VisitedBits(type);
+    auto mask = static_cast<uint8_t>(1 << (bit & 7));
+    auto seen = (bits[bit >> 3] & mask) != 0;
+    bits[bit >> 3] |= mask;
+    return seen;
+  }
+
+  // The bitmap of visited tables of a type. There are few table types per
+  // buffer, so they're found by a linear search.
+  std::vector<uint8_t> &VisitedBits(const void *type) {
+    for (auto it = visited_.begin(); it != visited_.end(); ++it) {
+      if (it->first == type) return it->second;
+    }
+    auto num_bits = static_cast<size_t>(end_ - buf_) / sizeof(uoffset_t);
+    visited_.push_back(std::make_pair(type,
+                                      std::vector<uint8_t>(num_bits / 8 + 1)));
+    return visited_.back().second;
+  }
+
+  // Each task verifies its range with its own copy of this verifier, so
+  // counters need no synchronization: every copy starts at the current depth
+  // and may count up to the tables remaining, and the counts are added up
+  // afterwards, so the limits set by the constructor hold as if the vector
+  // had been verified by a single task.
+  template<typename T> bool VerifyTablesInParallel(
+      const Vector<Offset<T>> *vec) {
+    auto size = vec->size();
+    auto num_workers = std::min(max_tasks_, size / min_tables_per_task_);
+    Verifier worker_proto(*this);
+    worker_proto.max_tasks_ = 1;
+    worker_proto.num_tables_ = 0;
+    worker_proto.max_tables_ = max_tables_ - num_tables_;
+    std::vector<Verifier> workers(num_workers, worker_proto);
+    std::vector<char> ok(num_workers, false);
+    std::atomic<bool> failed(false);
+    auto verify_range = [&](size_t w) {
+      auto &verifier = workers[w];
+      auto end = static_cast<uoffset_t>(size * (w + 1) / num_workers);
+      for (auto i = static_cast<uoffset_t>(size * w / num_workers); i < end;
+           i++) {
+        if (failed.load(std::memory_order_relaxed) ||
+            !vec->Get(i)->Verify(verifier)) {
+          failed = true;
+          return;
+        }
+      }
+      ok[w] = true;
+    };
+    executor_(num_workers, verify_range);
+    for (size_t w = 0; w < num_workers; w++) {
+      if (!ok[w]) return false;
+      num_tables_ += workers[w].num_tables_;
+    }
+    return Check(num_tables_ <= max_tables_);
+  }
+
   // Verify this whole buffer, starting with root type T.
   template<typename T> bool VerifyBuffer() {
     // Call T::Verify, which must be in the generated code for this type.
@@ -909,6 +1523,57 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
         Verify(*this);
   }
 
+  // Verify a buffer made with FinishSizePrefixed(), starting with root type
+  // T. The size prefix must fit within the data given to this Verifier, and
+  // all of the buffer must be within the size it indicates.
+  template<typename T> bool VerifySizePrefixedBuffer() {
+    if (!Verify<uoffset_t>(buf_)) return false;
+    auto size = ReadScalar<uoffset_t>(buf_);
+    if (!Check(size <= static_cast<size_t>(end_ - buf_) - sizeof(uoffset_t)))
+      return false;
+    auto buf = buf_;
+    auto end = end_;
+    buf_ += sizeof(uoffset_t);
+    end_ = buf_ + size;
+    last_vtable_ = nullptr;  // May have been verified against wider bounds.
+    visited_.clear();  // Indexed relative to buf_.
+    auto ok = VerifyBuffer<T>();
+    buf_ = buf;
+    end_ = end;
+    visited_.clear();
+    return ok;
+  }
+
+  // Verify a vtable can be read in its entirety, and that every field it
+  // marks present lies within the table's inline size (stored in the
+  // vtable), given the inline size of each field in field_sizes (indexed by
+  // field id). Fields beyond num_fields (written by a newer schema) are
+  // skipped, as no code reads them.
+  // Tables of one type commonly share their vtable, so the last vtable that
+  // passed is remembered, and checking it again is free.
+  bool VerifyVTable(const uint8_t *vtable, const voffset_t *field_sizes,
+                    size_t num_fields) {
+    if (vtable == last_vtable_ && field_sizes == last_field_sizes_)
+      return true;
+    // The vtable must at least hold its own size and the table's size.
+    if (!Verify<voffset_t>(vtable)) return false;
+    auto vtsize = ReadScalar<voffset_t>(vtable);
+    if (!Check(vtsize >= 2 * sizeof(voffset_t)) || !Verify(vtable, vtsize))
+      return false;
+    auto objsize = ReadScalar<voffset_t>(vtable + sizeof(voffset_t));
+    auto num_slots = static_cast<size_t>(vtsize / sizeof(voffset_t) - 2);
+    if (num_fields > num_slots) num_fields = num_slots;
+    auto slots = vtable + 2 * sizeof(voffset_t);
+    for (size_t i = 0; i < num_fields; i++) {
+      auto field_offset = ReadScalar<voffset_t>(slots + i * sizeof(voffset_t));
+      if (!Check(!field_offset || field_offset + field_sizes[i] <= objsize))
+        return false;
+    }
+    last_vtable_ = vtable;
+    last_field_sizes_ = field_sizes;
+    return true;
+  }
+
   // Called at the start of a table to increase counters measuring data
   // structure depth and amount, and possibly bails out with false if
   // limits set by the constructor have been hit. Needs to be balanced
@@ -932,6 +1597,13 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   size_t max_depth_;
   size_t num_tables_;
   size_t max_tables_;
+  const uint8_t *last_vtable_;
+  const voffset_t *last_field_sizes_;
+  Executor executor_;
+  size_t max_tasks_;
+  size_t min_tables_per_task_;
+  bool memoize_tables_;
+  std::vector<std::pair<const void *, std::vector<uint8_t>>> visited_;
 };
 
 // "structs" are flat structures that do not have an offset table, thus
@@ -1016,6 +1688,34 @@ class Table {
            verifier.Verify(vtable, ReadScalar<voffset_t>(vtable));
   }
 
+  // Verify the vtable of this table and all of its inline fields at once.
+  // field_sizes holds the inline size of each field, indexed by field id
+  // (0 for deprecated fields). Rather than checking every field against the
+  // buffer, this checks the table's inline data fits in the buffer, and
+  // leaves checking the fields lie within that data to the vtable, which is
+  // usually shared with the previous table.
+  // Call this instead of VerifyTableStart and VerifyField, then verify only
+  // required and offset fields individually.
+  template<size_t N> bool VerifyTableFields(
+      Verifier &verifier, const voffset_t (&field_sizes)[N]) const {
+    return VerifyTableFields(verifier, field_sizes, N);
+  }
+
+  bool VerifyTableFields(Verifier &verifier, const voffset_t *field_sizes,
+                         size_t num_fields) const {
+    if (!verifier.Verify<soffset_t>(data_) || !verifier.VerifyComplexity())
+      return false;
+    auto vtable = data_ - ReadScalar<soffset_t>(data_);
+    return verifier.VerifyVTable(vtable, field_sizes, num_fields) &&
+           verifier.Verify(data_, ReadScalar<voffset_t>(vtable +
+                                                        sizeof(voffset_t)));
+  }
+
+  // VerifyTableFields for tables without any fields.
+  bool VerifyTableFields(Verifier &verifier) const {
+    return VerifyTableFields(verifier, nullptr, 0);
+  }
+
   // Verify a particular field.
   template<typename T> bool VerifyField(const Verifier &verifier,
                                         voffset_t field) const {
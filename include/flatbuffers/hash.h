@@ -60,6 +60,17 @@ T HashFnv1a(const char *input) {
   return hash;
 }
 
+// HashFnv1a for the first length bytes of input, which may hold any bytes.
+template <typename T>
+T HashFnv1a(const char *input, size_t length) {
+  T hash = FnvTraits<T>::kOffsetBasis;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(input[i]);
+    hash *= FnvTraits<T>::kFnvPrime;
+  }
+  return hash;
+}
+
 template <typename T>
 struct NamedHashFunction {
   const char *name;
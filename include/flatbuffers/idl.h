@@ -22,6 +22,8 @@
 #include <stack>
 #include <memory>
 #include <functional>
+#include <iosfwd>
+#include <cstdio>
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/hash.h"
@@ -135,16 +137,32 @@ struct Type {
 // Represents a parsed scalar value, it's type, and field offset.
 struct Value {
   Value() : constant("0"), offset(static_cast<voffset_t>(
-                                ~(static_cast<voffset_t>(0U)))) {}
+                                ~(static_cast<voffset_t>(0U)))), i(0) {}
   Type type;
-  std::string constant;
+  std::string constant;  // Text of the value, only kept for schema values.
   voffset_t offset;
+  // The value itself, tagged by type.base_type: integers (including bools and
+  // enum values, 64-bit unsigned ones as their two's complement bit pattern)
+  // in i, floats in f, and the location of serialized strings, vectors,
+  // tables and structs in o. This is what JSON data is parsed into, and
+  // schema defaults are decoded into once, so no text conversions are needed
+  // when serializing.
+  union {
+    int64_t i;
+    double f;
+    uoffset_t o;
+  };
 };
 
 // Helper class that retains the original order of a set of identifiers and
 // also provides quick lookup.
+// Lookups go through an open addressing hash table, and can be done by
+// pointer and length, such that the parser can resolve names straight from
+// its input without constructing a string.
 template<typename T> class SymbolTable {
  public:
+  SymbolTable() : size_(0) {}
+
   ~SymbolTable() {
     for (auto it = vec.begin(); it != vec.end(); ++it) {
       delete *it;
@@ -152,20 +170,86 @@ template<typename T> class SymbolTable {
   }
 
   bool Add(const std::string &name, T *e) {
+    assert(e);  // nullptr marks an empty slot.
     vec.emplace_back(e);
-    auto it = dict.find(name);
-    if (it != dict.end()) return true;
-    dict[name] = e;
+    auto hash = Hash(name.c_str(), name.length());
+    if (Find(name.c_str(), name.length(), hash)) return true;
+    // Keep the load factor under 3/4, so probe sequences stay short.
+    if ((size_ + 1) * 4 > slots_.size() * 3) Grow();
+    auto &slot = slots_[EmptySlot(hash)];
+    slot.name = name;
+    slot.value = e;
+    slot.hash = hash;
+    size_++;
     return false;
   }
 
+  // Make room for n symbols in total, when known up front.
+  void Reserve(size_t n) {
+    vec.reserve(n);
+    size_t num_slots = 8;
+    while (n * 4 > num_slots * 3) num_slots *= 2;
+    if (num_slots > slots_.size()) Rehash(num_slots);
+  }
+
+  T *Lookup(const char *name, size_t len) const {
+    return Find(name, len, Hash(name, len));
+  }
+
+  T *Lookup(const char *name) const { return Lookup(name, strlen(name)); }
+
   T *Lookup(const std::string &name) const {
-    auto it = dict.find(name);
-    return it == dict.end() ? nullptr : it->second;
+    return Lookup(name.c_str(), name.length());
   }
 
  private:
-  std::map<std::string, T *> dict;      // quick lookup
+  struct Slot {
+    Slot() : value(nullptr), hash(0) {}
+
+    std::string name;
+    T *value;
+    uint32_t hash;
+  };
+
+  static uint32_t Hash(const char *name, size_t len) {
+    return HashFnv1a<uint32_t>(name, len);
+  }
+
+  T *Find(const char *name, size_t len, uint32_t hash) const {
+    if (slots_.empty()) return nullptr;
+    auto mask = slots_.size() - 1;
+    for (auto i = hash & mask; slots_[i].value; i = (i + 1) & mask) {
+      auto &slot = slots_[i];
+      if (slot.hash == hash && slot.name.length() == len &&
+          !memcmp(slot.name.c_str(), name, len))
+        return slot.value;
+    }
+    return nullptr;
+  }
+
+  size_t EmptySlot(uint32_t hash) const {
+    auto mask = slots_.size() - 1;
+    auto i = hash & mask;
+    while (slots_[i].value) i = (i + 1) & mask;
+    return i;
+  }
+
+  void Grow() { Rehash(slots_.empty() ? 8 : slots_.size() * 2); }
+
+  void Rehash(size_t num_slots) {
+    std::vector<Slot> old_slots(num_slots);
+    old_slots.swap(slots_);
+    for (auto it = old_slots.begin(); it != old_slots.end(); ++it) {
+      if (!it->value) continue;
+      auto &slot = slots_[EmptySlot(it->hash)];
+      slot.name.swap(it->name);
+      slot.value = it->value;
+      slot.hash = it->hash;
+    }
+  }
+
+  std::vector<Slot> slots_;  // quick lookup, size is a power of 2.
+  size_t size_;
 
  public:
   std::vector<T *> vec;  // Used to iterate in order of insertion
@@ -190,7 +274,7 @@ struct Definition {
 
 struct FieldDef : public Definition {
   FieldDef() : deprecated(false), required(false), key(false), padding(0),
-               used(false) {}
+               slot(0) {}
 
   Value value;
   bool deprecated; // Field is allowed to be present in old data, but can't be
@@ -198,7 +282,8 @@ struct FieldDef : public Definition {
   bool required;   // Field must always be present.
   bool key;        // Field functions as a key for creating sorted vectors.
   size_t padding;  // Bytes to always pad after this field.
-  bool used;       // Used during JSON parsing to check for repeated fields.
+  size_t slot;     // Index of this field in its struct, used by the JSON
+                   // parser to collect the values of an object.
 };
 
 struct StructDef : public Definition {
@@ -217,6 +302,22 @@ struct StructDef : public Definition {
     if (fields.vec.size()) fields.vec.back()->padding = padding;
   }
 
+  // Called once all fields are known, to number them and work out the
+  // order in which the JSON parser serializes them: backwards, and largest
+  // fields first if sorted by size.
+  void PlanSerialization() {
+    serialize_order.clear();
+    for (size_t i = 0; i < fields.vec.size(); i++) fields.vec[i]->slot = i;
+    for (size_t size = sortbysize ? sizeof(largest_scalar_t) : 1;
+         size;
+         size /= 2) {
+      for (auto it = fields.vec.rbegin(); it != fields.vec.rend(); ++it) {
+        if (!sortbysize || size == SizeOf((*it)->value.type.base_type))
+          serialize_order.push_back(*it);
+      }
+    }
+  }
+
   SymbolTable<FieldDef> fields;
   bool fixed;       // If it's struct, not a table.
   bool predecl;     // If it's used before it was defined.
@@ -224,6 +325,7 @@ struct StructDef : public Definition {
   bool has_key;     // It has a key field.
   size_t minalign;  // What the whole object needs to be aligned to.
   size_t bytesize;  // Size if fixed.
+  std::vector<FieldDef *> serialize_order;  // See PlanSerialization().
 };
 
 inline bool IsStruct(const Type &type) {
@@ -274,8 +376,11 @@ class Parser {
       source_(nullptr),
       cursor_(nullptr),
       line_(1),
+      binary_data_(nullptr),
+      binary_size_(0),
       proto_mode_(proto_mode),
-      strict_json_(strict_json) {
+      strict_json_(strict_json),
+      schema_(this) {
     // Just in case none are declared:
     namespaces_.push_back(new Namespace());
     known_attributes_.insert("deprecated");
@@ -289,6 +394,26 @@ class Parser {
     known_attributes_.insert("nested_flatbuffer");
   }
 
+  // Create a parser for JSON only, that shares the schema already parsed by
+  // schema_parser rather than parsing it again. Parsing JSON only reads the
+  // schema, so any number of these can be used concurrently, each from one
+  // thread. schema_parser must outlive them, and must not parse anything
+  // else while they are in use.
+  Parser(const Parser &schema_parser, bool strict_json)
+    : root_struct_def(schema_parser.root_struct_def),
+      file_identifier_(schema_parser.file_identifier_),
+      file_extension_(schema_parser.file_extension_),
+      source_(nullptr),
+      cursor_(nullptr),
+      line_(1),
+      binary_data_(nullptr),
+      binary_size_(0),
+      proto_mode_(false),
+      strict_json_(strict_json),
+      schema_(&schema_parser) {
+    namespaces_.push_back(new Namespace());
+  }
+
   ~Parser() {
     for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
       delete *it;
@@ -307,12 +432,58 @@ class Parser {
   bool Parse(const char *_source, const char **include_paths = nullptr,
              const char *source_filename = nullptr);
 
+  // Convert a stream of JSON objects of the root type, concatenated or
+  // newline delimited, read incrementally from `in`. Each object is written
+  // to `out` as a buffer made with FlatBufferBuilder::FinishSizePrefixed(),
+  // such that the result can be read back with SizePrefixedBufferIterator.
+  // Only one object is held in memory at a time, so this works on inputs
+  // of any size. The schema must have been parsed already.
+  // Returns false on error (see error_), with all objects before the one in
+  // error written to `out`.
+  bool ParseJsonStream(std::istream &in, std::ostream &out,
+                       const char *source_filename = nullptr);
+
+  // Serialize all definitions parsed so far (including those from included
+  // files) into builder as a binary schema (see reflection/reflection.fbs),
+  // which Deserialize() loads much faster than the text can be parsed.
+  // Documentation comments are not kept.
+  void Serialize(FlatBufferBuilder &builder) const;
+
+  // Load the definitions of a binary schema made by Serialize(), as if the
+  // schema it was made from was parsed. The buffer is verified first.
+  // Returns false on error (see error_, which names source_filename if
+  // given), after which this parser should not be used further.
+  bool Deserialize(const uint8_t *buf, size_t size,
+                   const char *source_filename = nullptr);
+
   // Set the root type. May override the one set in the schema.
   bool SetRootType(const char *name);
 
+  // The parser holding the definitions: this one, or the one whose schema
+  // it shares. Code generators and Serialize() must be given this one, as
+  // a parser sharing a schema holds no definitions of its own.
+  const Parser &GetSchema() const { return *schema_; }
+
   // Mark all definitions as already having code generated.
   void MarkGenerated();
 
+  // Have the generators use this binary data (e.g. a buffer loaded from a
+  // file) rather than builder_, without copying it. The data must stay
+  // around until generation is done. Reset by the next Parse().
+  void SetBinaryData(const uint8_t *buf, size_t size) {
+    binary_data_ = buf;
+    binary_size_ = size;
+  }
+
+  // The binary data the generators should work with: set by SetBinaryData(),
+  // or otherwise whatever was parsed into builder_.
+  const uint8_t *GetBinaryData() const {
+    return binary_data_ ? binary_data_ : builder_.GetBufferPointer();
+  }
+  size_t GetBinarySize() const {
+    return binary_data_ ? binary_size_ : builder_.GetSize();
+  }
+
   // Get the files recursively included by the given file. The returned
   // container will have at least the given file.
   std::set<std::string> GetIncludedFilesRecursive(
@@ -335,9 +506,10 @@ class Parser {
   void AddVector(bool sortbysize, int count);
   uoffset_t ParseVector(const Type &type);
   void ParseMetaData(Definition &def);
-  bool TryTypedValue(int dtoken, bool check, Value &e, BaseType req);
+  bool TryTypedValue(int dtoken, bool check, Value &e, BaseType req,
+                     bool keep_text);
   void ParseHash(Value &e, FieldDef* field);
-  void ParseSingleValue(Value &e);
+  void ParseSingleValue(Value &e, bool keep_text);
   int64_t ParseIntegerFromString(Type &type);
   StructDef *LookupCreateStruct(const std::string &name);
   void ParseEnum(bool is_union);
@@ -346,6 +518,8 @@ class Parser {
   void ParseDecl();
   void ParseProtoDecl();
   Type ParseTypeFromProtoType();
+  void ParseJsonRecord(const char *record);
+  void SetError(const std::string &msg, const char *source_filename);
 
  public:
   SymbolTable<StructDef> structs_;
@@ -365,16 +539,24 @@ class Parser {
   const char *source_, *cursor_;
   int line_;  // the current line being parsed
   int token_;
+  const uint8_t *binary_data_;
+  size_t binary_size_;
   std::stack<std::string> files_being_parsed_;
   bool proto_mode_;
   bool strict_json_;
+  const Parser *schema_;  // Where definitions are looked up, usually this.
   std::string attribute_;
   std::vector<std::string> doc_comment_;
 
   std::vector<std::pair<Value, FieldDef *>> field_stack_;
   std::vector<uint8_t> struct_stack_;
+  std::vector<size_t> slot_stack_;
 
   std::set<std::string> known_attributes_;
+
+  // You shouldn't really be copying instances of this class.
+  Parser(const Parser &);
+  Parser &operator=(const Parser &);
 };
 
 // Utility functions for multiple generators:
@@ -395,6 +577,12 @@ struct GeneratorOptions {
   bool output_enum_identifiers;
   bool prefixed_enums;
   bool include_dependence_headers;
+  // Threads GenerateText() may use to print large vectors (over 1024
+  // elements). The text is the same for any number of threads.
+  int num_threads;
+  // Generate C++ Verify() methods that check all inline fields of a table
+  // at once against its vtable, see Table::VerifyTableFields().
+  bool bulk_verify;
 
   // Possible options for the more general generator below.
   enum Language { kJava, kCSharp, kGo, kMAX };
@@ -403,8 +591,72 @@ struct GeneratorOptions {
 
   GeneratorOptions() : strict_json(false), indent_step(2),
                        output_enum_identifiers(true), prefixed_enums(true),
-                       include_dependence_headers(false),
-                       lang(GeneratorOptions::kJava) {}
+                       include_dependence_headers(false), num_threads(1),
+                       bulk_verify(false), lang(GeneratorOptions::kJava) {}
+};
+
+// Destination for generated text. Text is generated into `buffer`, which is
+// handed to Write() and emptied every time it grows past buffer_size, so
+// the memory used doesn't grow with the size of the output.
+class TextSink {
+ public:
+  explicit TextSink(size_t buffer_size = 64 * 1024)
+    : buffer_size_(buffer_size), ok_(true) {}
+  virtual ~TextSink() {}
+
+  // Writes out the buffer if it has filled up.
+  void Check() { if (buffer.size() >= buffer_size_) Flush(); }
+
+  // Writes out anything left in the buffer. Returns false if this or any
+  // earlier write failed.
+  bool Flush() {
+    if (!buffer.empty()) {
+      ok_ = Write(buffer.data(), buffer.size()) && ok_;
+      buffer.clear();
+    }
+    return ok_;
+  }
+
+  std::string buffer;
+
+ protected:
+  // Called with each full buffer. Returns false on failure.
+  virtual bool Write(const char *data, size_t size) = 0;
+
+ private:
+  size_t buffer_size_;
+  bool ok_;
+};
+
+// Writes generated text to a file opened by the caller.
+class FileTextSink : public TextSink {
+ public:
+  explicit FileTextSink(FILE *file, size_t buffer_size = 64 * 1024)
+    : TextSink(buffer_size), file_(file) {}
+
+ protected:
+  bool Write(const char *data, size_t size) {
+    return fwrite(data, 1, size, file_) == size;
+  }
+
+ private:
+  FILE *file_;
+};
+
+// Passes generated text to a callback, e.g. one that writes to a file
+// descriptor or socket.
+class CallbackTextSink : public TextSink {
+ public:
+  typedef std::function<bool(const char *data, size_t size)> Callback;
+  explicit CallbackTextSink(const Callback &callback,
+                            size_t buffer_size = 64 * 1024)
+    : TextSink(buffer_size), callback_(callback) {}
+
+ protected:
+  bool Write(const char *data, size_t size) { return callback_(data, size); }
+
+ private:
+  Callback callback_;
 };
 
 // Generate text (JSON) from a given FlatBuffer, and a given Parser
@@ -417,6 +669,13 @@ extern void GenerateText(const Parser &parser,
                          const void *flatbuffer,
                          const GeneratorOptions &opts,
                          std::string *text);
+
+// As above, but writes the text to sink as it is generated. Call
+// sink->Flush() afterwards to write out the remainder.
+extern void GenerateText(const Parser &parser,
+                         const void *flatbuffer,
+                         const GeneratorOptions &opts,
+                         TextSink *sink);
 extern bool GenerateTextFile(const Parser &parser,
                              const std::string &path,
                              const std::string &file_name,
@@ -430,6 +689,11 @@ extern bool GenerateBinary(const Parser &parser,
                            const std::string &file_name,
                            const GeneratorOptions &opts);
 
+// The name of the file GenerateBinary() writes to.
+extern std::string BinaryFileName(const Parser &parser,
+                                  const std::string &path,
+                                  const std::string &file_name);
+
 // Generate a C++ header from the definitions in the Parser object.
 // See idl_gen_cpp.
 extern std::string GenerateCPP(const Parser &parser,
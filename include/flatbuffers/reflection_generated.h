@@ -0,0 +1,650 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+#ifndef FLATBUFFERS_GENERATED_REFLECTION_REFLECTION_H_
+#define FLATBUFFERS_GENERATED_REFLECTION_REFLECTION_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+
+namespace reflection {
+
+struct Type;
+struct KeyValue;
+struct EnumVal;
+struct Enum;
+struct Field;
+struct Object;
+struct Schema;
+
+enum BaseType {
+  BaseType_None = 0,
+  BaseType_UType = 1,
+  BaseType_Bool = 2,
+  BaseType_Byte = 3,
+  BaseType_UByte = 4,
+  BaseType_Short = 5,
+  BaseType_UShort = 6,
+  BaseType_Int = 7,
+  BaseType_UInt = 8,
+  BaseType_Long = 9,
+  BaseType_ULong = 10,
+  BaseType_Float = 11,
+  BaseType_Double = 12,
+  BaseType_String = 13,
+  BaseType_Vector = 14,
+  BaseType_Obj = 15,
+  BaseType_Union = 16
+};
+
+inline const char **EnumNamesBaseType() {
+  static const char *names[] = { "None", "UType", "Bool", "Byte", "UByte", "Short", "UShort", "Int", "UInt", "Long", "ULong", "Float", "Double", "String", "Vector", "Obj", "Union", nullptr };
+  return names;
+}
+
+inline const char *EnumNameBaseType(BaseType e) { return EnumNamesBaseType()[e]; }
+
+struct Type FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  BaseType base_type() const { return static_cast<BaseType>(GetField<int8_t>(4, 0)); }
+  BaseType element() const { return static_cast<BaseType>(GetField<int8_t>(6, 0)); }
+  int32_t struct_index() const { return GetField<int32_t>(8, -1); }
+  int32_t enum_index() const { return GetField<int32_t>(10, -1); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int8_t>(verifier, 4 /* base_type */) &&
+           VerifyField<int8_t>(verifier, 6 /* element */) &&
+           VerifyField<int32_t>(verifier, 8 /* struct_index */) &&
+           VerifyField<int32_t>(verifier, 10 /* enum_index */) &&
+           verifier.EndTable();
+  }
+  static size_t MaxTableSize() { return 35; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    return size;
+  }
+};
+
+struct TypeBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_base_type(BaseType base_type) { fbb_.AddElement<int8_t>(4, static_cast<int8_t>(base_type), 0); }
+  void add_element(BaseType element) { fbb_.AddElement<int8_t>(6, static_cast<int8_t>(element), 0); }
+  void add_struct_index(int32_t struct_index) { fbb_.AddElement<int32_t>(8, struct_index, -1); }
+  void add_enum_index(int32_t enum_index) { fbb_.AddElement<int32_t>(10, enum_index, -1); }
+  TypeBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  TypeBuilder &operator=(const TypeBuilder &);
+  flatbuffers::Offset<Type> Finish() {
+    auto o = flatbuffers::Offset<Type>(fbb_.EndTable(start_, 4));
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Type> CreateType(flatbuffers::FlatBufferBuilder &_fbb,
+   BaseType base_type = BaseType_None,
+   BaseType element = BaseType_None,
+   int32_t struct_index = -1,
+   int32_t enum_index = -1) {
+  TypeBuilder builder_(_fbb);
+  builder_.add_enum_index(enum_index);
+  builder_.add_struct_index(struct_index);
+  builder_.add_element(element);
+  builder_.add_base_type(base_type);
+  return builder_.Finish();
+}
+
+inline size_t MaxTypeSize() {
+  return Type::MaxTableSize();
+}
+
+struct KeyValue FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  const flatbuffers::String *key() const { return GetPointer<const flatbuffers::String *>(4); }
+  const flatbuffers::String *value() const { return GetPointer<const flatbuffers::String *>(6); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 4 /* key */) &&
+           verifier.Verify(key()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 6 /* value */) &&
+           verifier.Verify(value()) &&
+           verifier.EndTable();
+  }
+  static size_t MaxTableSize() { return 29; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (key()) size += flatbuffers::MaxStringSize(key()->size());
+    if (value()) size += flatbuffers::MaxStringSize(value()->size());
+    return size;
+  }
+};
+
+struct KeyValueBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_key(flatbuffers::Offset<flatbuffers::String> key) { fbb_.AddOffset(4, key); }
+  void add_value(flatbuffers::Offset<flatbuffers::String> value) { fbb_.AddOffset(6, value); }
+  KeyValueBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  KeyValueBuilder &operator=(const KeyValueBuilder &);
+  flatbuffers::Offset<KeyValue> Finish() {
+    auto o = flatbuffers::Offset<KeyValue>(fbb_.EndTable(start_, 2));
+    fbb_.Required(o, 4);  // key
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<KeyValue> CreateKeyValue(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> key = 0,
+   flatbuffers::Offset<flatbuffers::String> value = 0) {
+  KeyValueBuilder builder_(_fbb);
+  builder_.add_value(value);
+  builder_.add_key(key);
+  return builder_.Finish();
+}
+
+inline size_t MaxKeyValueSize(
+   size_t key_length = 0,
+   size_t value_length = 0) {
+  return KeyValue::MaxTableSize() +
+         flatbuffers::MaxStringSize(key_length) +
+         flatbuffers::MaxStringSize(value_length);
+}
+
+struct EnumVal FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(4); }
+  int64_t value() const { return GetField<int64_t>(6, 0); }
+  int32_t union_index() const { return GetField<int32_t>(8, -1); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 4 /* name */) &&
+           verifier.Verify(name()) &&
+           VerifyField<int64_t>(verifier, 6 /* value */) &&
+           VerifyField<int32_t>(verifier, 8 /* union_index */) &&
+           verifier.EndTable();
+  }
+  static size_t MaxTableSize() { return 46; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (name()) size += flatbuffers::MaxStringSize(name()->size());
+    return size;
+  }
+};
+
+struct EnumValBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(4, name); }
+  void add_value(int64_t value) { fbb_.AddElement<int64_t>(6, value, 0); }
+  void add_union_index(int32_t union_index) { fbb_.AddElement<int32_t>(8, union_index, -1); }
+  EnumValBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  EnumValBuilder &operator=(const EnumValBuilder &);
+  flatbuffers::Offset<EnumVal> Finish() {
+    auto o = flatbuffers::Offset<EnumVal>(fbb_.EndTable(start_, 3));
+    fbb_.Required(o, 4);  // name
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<EnumVal> CreateEnumVal(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> name = 0,
+   int64_t value = 0,
+   int32_t union_index = -1) {
+  EnumValBuilder builder_(_fbb);
+  builder_.add_value(value);
+  builder_.add_union_index(union_index);
+  builder_.add_name(name);
+  return builder_.Finish();
+}
+
+inline size_t MaxEnumValSize(
+   size_t name_length = 0) {
+  return EnumVal::MaxTableSize() +
+         flatbuffers::MaxStringSize(name_length);
+}
+
+struct Enum FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(4); }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *defined_namespace() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(6); }
+  const flatbuffers::Vector<flatbuffers::Offset<EnumVal>> *values() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<EnumVal>> *>(8); }
+  uint8_t is_union() const { return GetField<uint8_t>(10, 0); }
+  const Type *underlying_type() const { return GetPointer<const Type *>(12); }
+  const flatbuffers::Vector<flatbuffers::Offset<KeyValue>> *attributes() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<KeyValue>> *>(14); }
+  uint8_t generated() const { return GetField<uint8_t>(16, 0); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 4 /* name */) &&
+           verifier.Verify(name()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 6 /* defined_namespace */) &&
+           verifier.Verify(defined_namespace()) &&
+           verifier.VerifyVectorOfStrings(defined_namespace()) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 8 /* values */) &&
+           verifier.Verify(values()) &&
+           verifier.VerifyVectorOfTables(values()) &&
+           VerifyField<uint8_t>(verifier, 10 /* is_union */) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 12 /* underlying_type */) &&
+           verifier.VerifyTable(underlying_type()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 14 /* attributes */) &&
+           verifier.Verify(attributes()) &&
+           verifier.VerifyVectorOfTables(attributes()) &&
+           VerifyField<uint8_t>(verifier, 16 /* generated */) &&
+           verifier.EndTable();
+  }
+  static size_t MaxTableSize() { return 62; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (name()) size += flatbuffers::MaxStringSize(name()->size());
+    if (defined_namespace()) {
+      size += flatbuffers::MaxVectorSize(defined_namespace()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < defined_namespace()->size(); i++)
+        size += flatbuffers::MaxStringSize(defined_namespace()->Get(i)->size());
+    }
+    if (values()) {
+      size += flatbuffers::MaxVectorSize(values()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < values()->size(); i++)
+        size += values()->Get(i)->MaxSerializedSize();
+    }
+    if (underlying_type()) size += underlying_type()->MaxSerializedSize();
+    if (attributes()) {
+      size += flatbuffers::MaxVectorSize(attributes()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < attributes()->size(); i++)
+        size += attributes()->Get(i)->MaxSerializedSize();
+    }
+    return size;
+  }
+};
+
+struct EnumBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(4, name); }
+  void add_defined_namespace(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> defined_namespace) { fbb_.AddOffset(6, defined_namespace); }
+  void add_values(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<EnumVal>>> values) { fbb_.AddOffset(8, values); }
+  void add_is_union(uint8_t is_union) { fbb_.AddElement<uint8_t>(10, is_union, 0); }
+  void add_underlying_type(flatbuffers::Offset<Type> underlying_type) { fbb_.AddOffset(12, underlying_type); }
+  void add_attributes(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<KeyValue>>> attributes) { fbb_.AddOffset(14, attributes); }
+  void add_generated(uint8_t generated) { fbb_.AddElement<uint8_t>(16, generated, 0); }
+  EnumBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  EnumBuilder &operator=(const EnumBuilder &);
+  flatbuffers::Offset<Enum> Finish() {
+    auto o = flatbuffers::Offset<Enum>(fbb_.EndTable(start_, 7));
+    fbb_.Required(o, 4);  // name
+    fbb_.Required(o, 8);  // values
+    fbb_.Required(o, 12);  // underlying_type
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Enum> CreateEnum(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> name = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> defined_namespace = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<EnumVal>>> values = 0,
+   uint8_t is_union = 0,
+   flatbuffers::Offset<Type> underlying_type = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<KeyValue>>> attributes = 0,
+   uint8_t generated = 0) {
+  EnumBuilder builder_(_fbb);
+  builder_.add_attributes(attributes);
+  builder_.add_underlying_type(underlying_type);
+  builder_.add_values(values);
+  builder_.add_defined_namespace(defined_namespace);
+  builder_.add_name(name);
+  builder_.add_generated(generated);
+  builder_.add_is_union(is_union);
+  return builder_.Finish();
+}
+
+inline size_t MaxEnumSize(
+   size_t name_length = 0,
+   size_t defined_namespace_length = 0,
+   size_t defined_namespace_bytes = 0,
+   size_t values_length = 0,
+   size_t values_size = 0,
+   size_t underlying_type_size = 0,
+   size_t attributes_length = 0,
+   size_t attributes_size = 0) {
+  return Enum::MaxTableSize() +
+         flatbuffers::MaxStringSize(name_length) +
+         flatbuffers::MaxVectorSize(defined_namespace_length, 4, 4) +
+         defined_namespace_length * flatbuffers::MaxStringSize(0) +
+         defined_namespace_bytes +
+         flatbuffers::MaxVectorSize(values_length, 4, 4) +
+         values_size +
+         underlying_type_size +
+         flatbuffers::MaxVectorSize(attributes_length, 4, 4) +
+         attributes_size;
+}
+
+struct Field FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(4); }
+  const Type *type() const { return GetPointer<const Type *>(6); }
+  uint16_t offset() const { return GetField<uint16_t>(8, 0); }
+  int64_t default_integer() const { return GetField<int64_t>(10, 0); }
+  double default_real() const { return GetField<double>(12, 0); }
+  const flatbuffers::String *default_text() const { return GetPointer<const flatbuffers::String *>(14); }
+  uint8_t deprecated() const { return GetField<uint8_t>(16, 0); }
+  uint8_t required() const { return GetField<uint8_t>(18, 0); }
+  uint8_t key() const { return GetField<uint8_t>(20, 0); }
+  uint32_t padding() const { return GetField<uint32_t>(22, 0); }
+  const flatbuffers::Vector<flatbuffers::Offset<KeyValue>> *attributes() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<KeyValue>> *>(24); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 4 /* name */) &&
+           verifier.Verify(name()) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 6 /* type */) &&
+           verifier.VerifyTable(type()) &&
+           VerifyField<uint16_t>(verifier, 8 /* offset */) &&
+           VerifyField<int64_t>(verifier, 10 /* default_integer */) &&
+           VerifyField<double>(verifier, 12 /* default_real */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 14 /* default_text */) &&
+           verifier.Verify(default_text()) &&
+           VerifyField<uint8_t>(verifier, 16 /* deprecated */) &&
+           VerifyField<uint8_t>(verifier, 18 /* required */) &&
+           VerifyField<uint8_t>(verifier, 20 /* key */) &&
+           VerifyField<uint32_t>(verifier, 22 /* padding */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 24 /* attributes */) &&
+           verifier.Verify(attributes()) &&
+           verifier.VerifyVectorOfTables(attributes()) &&
+           verifier.EndTable();
+  }
+  static size_t MaxTableSize() { return 104; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (name()) size += flatbuffers::MaxStringSize(name()->size());
+    if (type()) size += type()->MaxSerializedSize();
+    if (default_text()) size += flatbuffers::MaxStringSize(default_text()->size());
+    if (attributes()) {
+      size += flatbuffers::MaxVectorSize(attributes()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < attributes()->size(); i++)
+        size += attributes()->Get(i)->MaxSerializedSize();
+    }
+    return size;
+  }
+};
+
+struct FieldBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(4, name); }
+  void add_type(flatbuffers::Offset<Type> type) { fbb_.AddOffset(6, type); }
+  void add_offset(uint16_t offset) { fbb_.AddElement<uint16_t>(8, offset, 0); }
+  void add_default_integer(int64_t default_integer) { fbb_.AddElement<int64_t>(10, default_integer, 0); }
+  void add_default_real(double default_real) { fbb_.AddElement<double>(12, default_real, 0); }
+  void add_default_text(flatbuffers::Offset<flatbuffers::String> default_text) { fbb_.AddOffset(14, default_text); }
+  void add_deprecated(uint8_t deprecated) { fbb_.AddElement<uint8_t>(16, deprecated, 0); }
+  void add_required(uint8_t required) { fbb_.AddElement<uint8_t>(18, required, 0); }
+  void add_key(uint8_t key) { fbb_.AddElement<uint8_t>(20, key, 0); }
+  void add_padding(uint32_t padding) { fbb_.AddElement<uint32_t>(22, padding, 0); }
+  void add_attributes(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<KeyValue>>> attributes) { fbb_.AddOffset(24, attributes); }
+  FieldBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  FieldBuilder &operator=(const FieldBuilder &);
+  flatbuffers::Offset<Field> Finish() {
+    auto o = flatbuffers::Offset<Field>(fbb_.EndTable(start_, 11));
+    fbb_.Required(o, 4);  // name
+    fbb_.Required(o, 6);  // type
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Field> CreateField(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> name = 0,
+   flatbuffers::Offset<Type> type = 0,
+   uint16_t offset = 0,
+   int64_t default_integer = 0,
+   double default_real = 0,
+   flatbuffers::Offset<flatbuffers::String> default_text = 0,
+   uint8_t deprecated = 0,
+   uint8_t required = 0,
+   uint8_t key = 0,
+   uint32_t padding = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<KeyValue>>> attributes = 0) {
+  FieldBuilder builder_(_fbb);
+  builder_.add_default_real(default_real);
+  builder_.add_default_integer(default_integer);
+  builder_.add_attributes(attributes);
+  builder_.add_padding(padding);
+  builder_.add_default_text(default_text);
+  builder_.add_type(type);
+  builder_.add_name(name);
+  builder_.add_offset(offset);
+  builder_.add_key(key);
+  builder_.add_required(required);
+  builder_.add_deprecated(deprecated);
+  return builder_.Finish();
+}
+
+inline size_t MaxFieldSize(
+   size_t name_length = 0,
+   size_t type_size = 0,
+   size_t default_text_length = 0,
+   size_t attributes_length = 0,
+   size_t attributes_size = 0) {
+  return Field::MaxTableSize() +
+         flatbuffers::MaxStringSize(name_length) +
+         type_size +
+         flatbuffers::MaxStringSize(default_text_length) +
+         flatbuffers::MaxVectorSize(attributes_length, 4, 4) +
+         attributes_size;
+}
+
+struct Object FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(4); }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *defined_namespace() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(6); }
+  const flatbuffers::Vector<flatbuffers::Offset<Field>> *fields() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Field>> *>(8); }
+  uint8_t is_struct() const { return GetField<uint8_t>(10, 0); }
+  uint8_t sortbysize() const { return GetField<uint8_t>(12, 1); }
+  uint8_t has_key() const { return GetField<uint8_t>(14, 0); }
+  int32_t minalign() const { return GetField<int32_t>(16, 0); }
+  int32_t bytesize() const { return GetField<int32_t>(18, 0); }
+  const flatbuffers::Vector<flatbuffers::Offset<KeyValue>> *attributes() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<KeyValue>> *>(20); }
+  uint8_t generated() const { return GetField<uint8_t>(22, 0); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 4 /* name */) &&
+           verifier.Verify(name()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 6 /* defined_namespace */) &&
+           verifier.Verify(defined_namespace()) &&
+           verifier.VerifyVectorOfStrings(defined_namespace()) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 8 /* fields */) &&
+           verifier.Verify(fields()) &&
+           verifier.VerifyVectorOfTables(fields()) &&
+           VerifyField<uint8_t>(verifier, 10 /* is_struct */) &&
+           VerifyField<uint8_t>(verifier, 12 /* sortbysize */) &&
+           VerifyField<uint8_t>(verifier, 14 /* has_key */) &&
+           VerifyField<int32_t>(verifier, 16 /* minalign */) &&
+           VerifyField<int32_t>(verifier, 18 /* bytesize */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 20 /* attributes */) &&
+           verifier.Verify(attributes()) &&
+           verifier.VerifyVectorOfTables(attributes()) &&
+           VerifyField<uint8_t>(verifier, 22 /* generated */) &&
+           verifier.EndTable();
+  }
+  static size_t MaxTableSize() { return 77; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (name()) size += flatbuffers::MaxStringSize(name()->size());
+    if (defined_namespace()) {
+      size += flatbuffers::MaxVectorSize(defined_namespace()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < defined_namespace()->size(); i++)
+        size += flatbuffers::MaxStringSize(defined_namespace()->Get(i)->size());
+    }
+    if (fields()) {
+      size += flatbuffers::MaxVectorSize(fields()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < fields()->size(); i++)
+        size += fields()->Get(i)->MaxSerializedSize();
+    }
+    if (attributes()) {
+      size += flatbuffers::MaxVectorSize(attributes()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < attributes()->size(); i++)
+        size += attributes()->Get(i)->MaxSerializedSize();
+    }
+    return size;
+  }
+};
+
+struct ObjectBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(4, name); }
+  void add_defined_namespace(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> defined_namespace) { fbb_.AddOffset(6, defined_namespace); }
+  void add_fields(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Field>>> fields) { fbb_.AddOffset(8, fields); }
+  void add_is_struct(uint8_t is_struct) { fbb_.AddElement<uint8_t>(10, is_struct, 0); }
+  void add_sortbysize(uint8_t sortbysize) { fbb_.AddElement<uint8_t>(12, sortbysize, 1); }
+  void add_has_key(uint8_t has_key) { fbb_.AddElement<uint8_t>(14, has_key, 0); }
+  void add_minalign(int32_t minalign) { fbb_.AddElement<int32_t>(16, minalign, 0); }
+  void add_bytesize(int32_t bytesize) { fbb_.AddElement<int32_t>(18, bytesize, 0); }
+  void add_attributes(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<KeyValue>>> attributes) { fbb_.AddOffset(20, attributes); }
+  void add_generated(uint8_t generated) { fbb_.AddElement<uint8_t>(22, generated, 0); }
+  ObjectBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  ObjectBuilder &operator=(const ObjectBuilder &);
+  flatbuffers::Offset<Object> Finish() {
+    auto o = flatbuffers::Offset<Object>(fbb_.EndTable(start_, 10));
+    fbb_.Required(o, 4);  // name
+    fbb_.Required(o, 8);  // fields
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Object> CreateObject(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> name = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> defined_namespace = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Field>>> fields = 0,
+   uint8_t is_struct = 0,
+   uint8_t sortbysize = 1,
+   uint8_t has_key = 0,
+   int32_t minalign = 0,
+   int32_t bytesize = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<KeyValue>>> attributes = 0,
+   uint8_t generated = 0) {
+  ObjectBuilder builder_(_fbb);
+  builder_.add_attributes(attributes);
+  builder_.add_bytesize(bytesize);
+  builder_.add_minalign(minalign);
+  builder_.add_fields(fields);
+  builder_.add_defined_namespace(defined_namespace);
+  builder_.add_name(name);
+  builder_.add_generated(generated);
+  builder_.add_has_key(has_key);
+  builder_.add_sortbysize(sortbysize);
+  builder_.add_is_struct(is_struct);
+  return builder_.Finish();
+}
+
+inline size_t MaxObjectSize(
+   size_t name_length = 0,
+   size_t defined_namespace_length = 0,
+   size_t defined_namespace_bytes = 0,
+   size_t fields_length = 0,
+   size_t fields_size = 0,
+   size_t attributes_length = 0,
+   size_t attributes_size = 0) {
+  return Object::MaxTableSize() +
+         flatbuffers::MaxStringSize(name_length) +
+         flatbuffers::MaxVectorSize(defined_namespace_length, 4, 4) +
+         defined_namespace_length * flatbuffers::MaxStringSize(0) +
+         defined_namespace_bytes +
+         flatbuffers::MaxVectorSize(fields_length, 4, 4) +
+         fields_size +
+         flatbuffers::MaxVectorSize(attributes_length, 4, 4) +
+         attributes_size;
+}
+
+struct Schema FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  const flatbuffers::Vector<flatbuffers::Offset<Object>> *objects() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Object>> *>(4); }
+  const flatbuffers::Vector<flatbuffers::Offset<Enum>> *enums() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Enum>> *>(6); }
+  const flatbuffers::String *file_ident() const { return GetPointer<const flatbuffers::String *>(8); }
+  const flatbuffers::String *file_ext() const { return GetPointer<const flatbuffers::String *>(10); }
+  int32_t root_table() const { return GetField<int32_t>(12, -1); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 4 /* objects */) &&
+           verifier.Verify(objects()) &&
+           verifier.VerifyVectorOfTables(objects()) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 6 /* enums */) &&
+           verifier.Verify(enums()) &&
+           verifier.VerifyVectorOfTables(enums()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 8 /* file_ident */) &&
+           verifier.Verify(file_ident()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 10 /* file_ext */) &&
+           verifier.Verify(file_ext()) &&
+           VerifyField<int32_t>(verifier, 12 /* root_table */) &&
+           verifier.EndTable();
+  }
+  static size_t MaxTableSize() { return 56; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (objects()) {
+      size += flatbuffers::MaxVectorSize(objects()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < objects()->size(); i++)
+        size += objects()->Get(i)->MaxSerializedSize();
+    }
+    if (enums()) {
+      size += flatbuffers::MaxVectorSize(enums()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < enums()->size(); i++)
+        size += enums()->Get(i)->MaxSerializedSize();
+    }
+    if (file_ident()) size += flatbuffers::MaxStringSize(file_ident()->size());
+    if (file_ext()) size += flatbuffers::MaxStringSize(file_ext()->size());
+    return size;
+  }
+};
+
+struct SchemaBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_objects(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Object>>> objects) { fbb_.AddOffset(4, objects); }
+  void add_enums(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Enum>>> enums) { fbb_.AddOffset(6, enums); }
+  void add_file_ident(flatbuffers::Offset<flatbuffers::String> file_ident) { fbb_.AddOffset(8, file_ident); }
+  void add_file_ext(flatbuffers::Offset<flatbuffers::String> file_ext) { fbb_.AddOffset(10, file_ext); }
+  void add_root_table(int32_t root_table) { fbb_.AddElement<int32_t>(12, root_table, -1); }
+  SchemaBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  SchemaBuilder &operator=(const SchemaBuilder &);
+  flatbuffers::Offset<Schema> Finish() {
+    auto o = flatbuffers::Offset<Schema>(fbb_.EndTable(start_, 5));
+    fbb_.Required(o, 4);  // objects
+    fbb_.Required(o, 6);  // enums
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Schema> CreateSchema(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Object>>> objects = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Enum>>> enums = 0,
+   flatbuffers::Offset<flatbuffers::String> file_ident = 0,
+   flatbuffers::Offset<flatbuffers::String> file_ext = 0,
+   int32_t root_table = -1) {
+  SchemaBuilder builder_(_fbb);
+  builder_.add_root_table(root_table);
+  builder_.add_file_ext(file_ext);
+  builder_.add_file_ident(file_ident);
+  builder_.add_enums(enums);
+  builder_.add_objects(objects);
+  return builder_.Finish();
+}
+
+inline size_t MaxSchemaSize(
+   size_t objects_length = 0,
+   size_t objects_size = 0,
+   size_t enums_length = 0,
+   size_t enums_size = 0,
+   size_t file_ident_length = 0,
+   size_t file_ext_length = 0) {
+  return Schema::MaxTableSize() +
+         flatbuffers::MaxVectorSize(objects_length, 4, 4) +
+         objects_size +
+         flatbuffers::MaxVectorSize(enums_length, 4, 4) +
+         enums_size +
+         flatbuffers::MaxStringSize(file_ident_length) +
+         flatbuffers::MaxStringSize(file_ext_length);
+}
+
+inline const Schema *GetSchema(const void *buf) { return flatbuffers::GetRoot<Schema>(buf); }
+
+inline bool VerifySchemaBuffer(flatbuffers::Verifier &verifier) { return verifier.VerifyBuffer<Schema>(); }
+
+inline size_t SchemaBufferMaxSize(const Schema *root) { return root->MaxSerializedSize() + flatbuffers::MaxFinishSize(8); }
+
+inline const char *SchemaIdentifier() { return "BFBS"; }
+
+inline bool SchemaBufferHasIdentifier(const void *buf) { return flatbuffers::BufferHasIdentifier(buf, SchemaIdentifier()); }
+
+inline void FinishSchemaBuffer(flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Schema> root) { fbb.Finish(root, SchemaIdentifier()); }
+
+}  // namespace reflection
+
+#endif  // FLATBUFFERS_GENERATED_REFLECTION_REFLECTION_H_
@@ -17,11 +17,21 @@
 #ifndef FLATBUFFERS_UTIL_H_
 #define FLATBUFFERS_UTIL_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <limits>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
@@ -35,6 +45,9 @@
 #include <direct.h>
 #else
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <limits.h>
 #endif
 
@@ -58,6 +71,288 @@ template<> inline std::string NumToString<unsigned char>(unsigned char t) {
   return NumToString(static_cast<int>(t));
 }
 
+// Write numbers as text into a buffer supplied by the caller, which must
+// have room for kMaxNumChars characters. These return the end of the text
+// written, which is not 0 terminated. Unlike NumToString, these don't
+// allocate, for use in tight loops such as the JSON generator.
+const size_t kMaxNumChars = 32;
+
+// Integers are written two digits at a time, using a table of digit pairs.
+inline char *UIntToChars(uint64_t val, char *buf) {
+  static const char digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+  char digits[20];
+  auto p = digits + sizeof(digits);
+  while (val >= 100) {
+    auto pair = digit_pairs + (val % 100) * 2;
+    val /= 100;
+    *--p = pair[1];
+    *--p = pair[0];
+  }
+  if (val >= 10) {
+    auto pair = digit_pairs + val * 2;
+    *--p = pair[1];
+    *--p = pair[0];
+  } else {
+    *--p = static_cast<char>('0' + val);
+  }
+  auto len = digits + sizeof(digits) - p;
+  memcpy(buf, p, len);
+  return buf + len;
+}
+
+inline char *IntToChars(int64_t val, char *buf) {
+  if (val >= 0) return UIntToChars(static_cast<uint64_t>(val), buf);
+  *buf++ = '-';
+  return UIntToChars(0 - static_cast<uint64_t>(val), buf);
+}
+
+// Shortest decimal digits of a floating point value, using the Grisu2
+// algorithm (Loitsch, "Printing Floating-Point Numbers Quickly and
+// Accurately with Integers"). The digits always read back as the same value,
+// and are the shortest that do in all but rare cases.
+
+// A floating point number f * 2^e, with a 64 bit significand.
+struct DiyFp {
+  DiyFp(uint64_t _f, int _e) : f(_f), e(_e) {}
+
+  DiyFp operator-(const DiyFp &o) const { return DiyFp(f - o.f, e); }
+
+  // Multiplies the significands, keeping the (rounded) upper 64 bits.
+  DiyFp operator*(const DiyFp &o) const {
+    const uint64_t mask32 = 0xFFFFFFFF;
+    uint64_t a = f >> 32, b = f & mask32, c = o.f >> 32, d = o.f & mask32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t mid = (bd >> 32) + (ad & mask32) + (bc & mask32) + (1U << 31);
+    return DiyFp(ac + (ad >> 32) + (bc >> 32) + (mid >> 32), e + o.e + 64);
+  }
+
+  DiyFp Normalize() const {
+    DiyFp n = *this;
+    while (!(n.f & (1ULL << 63))) { n.f <<= 1; n.e--; }
+    return n;
+  }
+
+  uint64_t f;
+  int e;
+};
+
+// 10^k for k = -348, -340 .. 340, normalized, for scaling a DiyFp into the
+// range where its digits can be generated with integer arithmetic.
+inline DiyFp CachedPower(int e, int *k) {
+  static const uint64_t pow_f[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+  };
+  static const int16_t pow_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066,
+  };
+  // The smallest power that brings e into [-60, -32], using 1/log2(10).
+  double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int ik = static_cast<int>(dk);
+  if (dk - ik > 0.0) ik++;
+  auto index = static_cast<size_t>((ik >> 3) + 1);
+  *k = -(-348 + static_cast<int>(index << 3));
+  return DiyFp(pow_f[index], pow_e[index]);
+}
+
+// Generates the digits of w, the scaled value, which may be anything within
+// delta below the upper boundary mp. Adds the decimal exponent to *k.
+inline int GrisuDigits(const DiyFp &w, const DiyFp &mp, uint64_t delta,
+                       char *digits, int *k) {
+  static const uint64_t pow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+  };
+  // Walks the last digit down towards w while that stays within delta and
+  // gets closer to w.
+  auto round_last = [&](int len, uint64_t rest, uint64_t ten_kappa,
+                   uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w ||
+            wp_w - rest > rest + ten_kappa - wp_w)) {
+      digits[len - 1]--;
+      rest += ten_kappa;
+    }
+  };
+  const DiyFp one(1ULL << -mp.e, mp.e);
+  const uint64_t wp_w = (mp - w).f;
+  auto p1 = static_cast<uint32_t>(mp.f >> -one.e);  // Integer part.
+  uint64_t p2 = mp.f & (one.f - 1);                  // Fractional part.
+  int kappa = 1;
+  while (kappa < 10 && p1 >= pow10[kappa]) kappa++;
+  int len = 0;
+  while (kappa > 0) {
+    auto d = static_cast<uint32_t>(p1 / pow10[kappa - 1]);
+    p1 %= static_cast<uint32_t>(pow10[kappa - 1]);
+    if (d || len) digits[len++] = static_cast<char>('0' + d);
+    kappa--;
+    uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      *k += kappa;
+      round_last(len, rest, pow10[kappa] << -one.e, wp_w);
+      return len;
+    }
+  }
+  for (;;) {
+    p2 *= 10;
+    delta *= 10;
+    auto d = static_cast<char>(p2 >> -one.e);
+    if (d || len) digits[len++] = static_cast<char>('0' + d);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *k += kappa;
+      round_last(len, p2, one.f, -kappa < 20 ? wp_w * pow10[-kappa] : 0);
+      return len;
+    }
+  }
+}
+
+// Writes the shortest digits of a positive, finite val into digits (room
+// for 18), returning their count, with *k set such that val = digits * 10^k.
+template<typename T> int ShortestDigits(T val, char *digits, int *k) {
+  typedef typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type
+    Bits;
+  const int mantissa_bits = std::numeric_limits<T>::digits - 1;
+  const int exponent_bias = std::numeric_limits<T>::max_exponent - 1;
+  const uint64_t hidden_bit = 1ULL << mantissa_bits;
+  Bits bits;
+  memcpy(&bits, &val, sizeof(bits));
+  auto biased_e = static_cast<int>(bits >> mantissa_bits);
+  uint64_t f = bits & (hidden_bit - 1);
+  int e = 1 - exponent_bias - mantissa_bits;
+  if (biased_e) {
+    f += hidden_bit;
+    e += biased_e - 1;
+  }
+  // The boundaries halfway to the neighbouring values, which are closer
+  // below a power of 2.
+  DiyFp plus = DiyFp((f << 1) + 1, e - 1).Normalize();
+  DiyFp minus = f == hidden_bit && biased_e > 1 ? DiyFp((f << 2) - 1, e - 2)
+                                                : DiyFp((f << 1) - 1, e - 1);
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  auto c = CachedPower(plus.e, k);
+  auto w = DiyFp(f, e).Normalize() * c;
+  auto wp = plus * c;
+  auto wm = minus * c;
+  wm.f++;
+  wp.f--;
+  return GrisuDigits(w, wp, wp.f - wm.f, digits, k);
+}
+
+// Writes the shortest text that reads back as exactly val, laid out like
+// printf's "%g" with a precision of at least the 6 digits NumToString()
+// uses, so values NumToString() printed without loss come out the same.
+template<typename T> char *FloatToChars(T val, char *buf) {
+  // Integers are common, and print as such unless they need an exponent.
+  if (val > -1e6 && val < 1e6 &&
+      static_cast<T>(static_cast<int32_t>(val)) == val &&
+      !(val == 0 && std::signbit(val))) {
+    return IntToChars(static_cast<int32_t>(val), buf);
+  }
+  if (val == 0 || !std::isfinite(val)) {
+    return buf + snprintf(buf, kMaxNumChars, "%g", static_cast<double>(val));
+  }
+  if (val < 0) {
+    *buf++ = '-';
+    val = -val;
+  }
+  char digits[20];
+  int k = 0;
+  int len = ShortestDigits(val, digits, &k);
+  while (len > 1 && digits[len - 1] == '0') {
+    len--;
+    k++;
+  }
+  int exp10 = len - 1 + k;  // Exponent of the first digit.
+  if (exp10 < -4 || exp10 >= std::max(len, 6)) {
+    *buf++ = digits[0];
+    if (len > 1) {
+      *buf++ = '.';
+      memcpy(buf, digits + 1, len - 1);
+      buf += len - 1;
+    }
+    *buf++ = 'e';
+    *buf++ = exp10 < 0 ? '-' : '+';
+    if (exp10 < 0) exp10 = -exp10;
+    if (exp10 < 10) *buf++ = '0';
+    return UIntToChars(static_cast<uint64_t>(exp10), buf);
+  } else if (exp10 < 0) {
+    *buf++ = '0';
+    *buf++ = '.';
+    memset(buf, '0', -exp10 - 1);
+    buf += -exp10 - 1;
+    memcpy(buf, digits, len);
+    return buf + len;
+  } else if (len <= exp10 + 1) {
+    memcpy(buf, digits, len);
+    memset(buf + len, '0', exp10 + 1 - len);
+    return buf + exp10 + 1;
+  } else {
+    memcpy(buf, digits, exp10 + 1);
+    buf[exp10 + 1] = '.';
+    memcpy(buf + exp10 + 2, digits + exp10 + 1, len - exp10 - 1);
+    return buf + len + 1;
+  }
+}
+
+template<typename T> char *NumToChars(T t, char *buf) {
+  return std::is_signed<T>::value
+    ? IntToChars(static_cast<int64_t>(t), buf)
+    : UIntToChars(static_cast<uint64_t>(t), buf);
+}
+template<> inline char *NumToChars<float>(float t, char *buf) {
+  return FloatToChars(t, buf);
+}
+template<> inline char *NumToChars<double>(double t, char *buf) {
+  return FloatToChars(t, buf);
+}
+
 // Convert an integer value to a hexadecimal string.
 // The returned string length is always xdigits long, prefixed by 0 digits.
 // For example, IntToStringHex(0x23, 8) returns the string "00000023".
@@ -98,6 +393,109 @@ inline bool LoadFile(const char *name, bool binary, std::string *buf) {
   return !ifs.bad();
 }
 
+// A read-only view of the contents of a file, mapped into memory where
+// possible, so even very large files can be used without reading them into
+// the heap first. The data is always followed by a 0 byte, so text files can
+// be passed to Parser::Parse() directly.
+// If the file can't be mapped (e.g. a pipe), it is loaded with LoadFile().
+class MappedFile {
+ public:
+  MappedFile() : data_(nullptr), size_(0), mapping_(nullptr),
+                 mapping_size_(0) {}
+  ~MappedFile() { Close(); }
+
+  // Map file "name", returning false if it can't be opened.
+  bool Open(const char *name) {
+    Close();
+    if (!Map(name)) {
+      if (!LoadFile(name, true, &loaded_)) return false;
+      data_ = loaded_.c_str();
+      size_ = loaded_.size();
+    }
+    return true;
+  }
+
+  void Close() {
+    if (mapping_) {
+      #ifdef _WIN32
+        UnmapViewOfFile(mapping_);
+      #else
+        munmap(mapping_, mapping_size_);
+      #endif
+      mapping_ = nullptr;
+    }
+    loaded_.clear();
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  // You shouldn't copy these, the mapping would be unmapped twice.
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  bool Map(const char *name) {
+    #ifdef _WIN32
+      auto file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file == INVALID_HANDLE_VALUE) return false;
+      LARGE_INTEGER file_size;
+      SYSTEM_INFO info;
+      GetSystemInfo(&info);
+      HANDLE map = nullptr;
+      // There has to be space left in the last page for the 0 byte past the
+      // end, which the mapping will have zeroed.
+      if (GetFileSizeEx(file, &file_size) && file_size.QuadPart &&
+          file_size.QuadPart % info.dwPageSize) {
+        map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      }
+      CloseHandle(file);
+      if (!map) return false;
+      mapping_ = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+      CloseHandle(map);
+      if (!mapping_) return false;
+      size_ = static_cast<size_t>(file_size.QuadPart);
+    #else
+      auto fd = open(name, O_RDONLY);
+      if (fd < 0) return false;
+      struct stat st;
+      if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size) {
+        close(fd);
+        return false;
+      }
+      size_ = static_cast<size_t>(st.st_size);
+      // Reserve one byte more than the file, rounded up to whole pages, then
+      // map the file over the start of it. Everything past the end of the
+      // file reads as 0, even when it ends exactly on a page boundary.
+      auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      mapping_size_ = (size_ + page_size) & ~(page_size - 1);
+      mapping_ = mmap(nullptr, mapping_size_, PROT_READ,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mapping_ == MAP_FAILED ||
+          mmap(mapping_, size_, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) ==
+            MAP_FAILED) {
+        if (mapping_ != MAP_FAILED) munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        size_ = 0;
+        close(fd);
+        return false;
+      }
+      close(fd);
+    #endif
+    data_ = static_cast<const char *>(mapping_);
+    return true;
+  }
+
+  const char *data_;
+  size_t size_;
+  void *mapping_;
+  size_t mapping_size_;
+  std::string loaded_;  // When mapping wasn't possible.
+};
+
 // Save data "buf" of length "len" bytes into a file
 // "name" returning true if successful, false otherwise.
 // If "binary" is false data is written using ifstream's
@@ -267,6 +665,18 @@ inline std::string WordWrap(const std::string in, size_t max_length,
   return wrapped;
 }
 
+// Runs task(0) .. task(num_tasks - 1) each on a thread of its own, the first
+// on the calling thread, and returns once all have finished. Suitable as a
+// Verifier::Executor. Needs linking with the platform's threads library.
+inline void RunOnThreads(size_t num_tasks,
+                         const std::function<void(size_t)> &task) {
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_tasks; i++)
+    threads.push_back(std::thread(task, i));
+  if (num_tasks) task(0);
+  for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+}
+
 }  // namespace flatbuffers
 
 #endif  // FLATBUFFERS_UTIL_H_
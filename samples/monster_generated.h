@@ -39,6 +39,8 @@ inline const char *EnumNameAny(Any e) { return EnumNamesAny()[e]; }
 
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, Any type);
 
+inline size_t MaxSerializedSizeAny(const void *union_obj, Any type);
+
 MANUALLY_ALIGNED_STRUCT(4) Vec3 FLATBUFFERS_FINAL_CLASS {
  private:
   float x_;
@@ -74,6 +76,13 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyField<int8_t>(verifier, 16 /* color */) &&
            verifier.EndTable();
   }
+  static size_t MaxTableSize() { return 61; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (name()) size += flatbuffers::MaxStringSize(name()->size());
+    if (inventory()) size += flatbuffers::MaxVectorSize(inventory()->size(), 1, 1);
+    return size;
+  }
 };
 
 struct MonsterBuilder {
@@ -110,6 +119,14 @@ inline flatbuffers::Offset<Monster> CreateMonster(flatbuffers::FlatBufferBuilder
   return builder_.Finish();
 }
 
+inline size_t MaxMonsterSize(
+   size_t name_length = 0,
+   size_t inventory_length = 0) {
+  return Monster::MaxTableSize() +
+         flatbuffers::MaxStringSize(name_length) +
+         flatbuffers::MaxVectorSize(inventory_length, 1, 1);
+}
+
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, Any type) {
   switch (type) {
     case Any_NONE: return true;
@@ -118,10 +135,19 @@ inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, An
   }
 }
 
+inline size_t MaxSerializedSizeAny(const void *union_obj, Any type) {
+  switch (type) {
+    case Any_Monster: return reinterpret_cast<const Monster *>(union_obj)->MaxSerializedSize();
+    default: return 0;
+  }
+}
+
 inline const Monster *GetMonster(const void *buf) { return flatbuffers::GetRoot<Monster>(buf); }
 
 inline bool VerifyMonsterBuffer(flatbuffers::Verifier &verifier) { return verifier.VerifyBuffer<Monster>(); }
 
+inline size_t MonsterBufferMaxSize(const Monster *root) { return root->MaxSerializedSize() + flatbuffers::MaxFinishSize(8); }
+
 inline void FinishMonsterBuffer(flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<Monster> root) { fbb.Finish(root); }
 
 }  // namespace Sample
@@ -18,6 +18,10 @@
 #include "flatbuffers/idl.h"
 #include "flatbuffers/util.h"
 
+#include <atomic>
+#include <iostream>
+#include <thread>
+
 static void Error(const char *err, const char *obj = nullptr,
                   bool usage = false, bool show_exe_name = true);
 
@@ -31,6 +35,9 @@ struct Generator {
   const char *generator_opt;
   const char *lang_name;
   flatbuffers::GeneratorOptions::Language lang;
+  // Whether it outputs the data parsed from a file, rather than code for
+  // the definitions in the schema.
+  bool outputs_data;
   const char *generator_help;
 
   std::string (*make_rule)(const flatbuffers::Parser &parser,
@@ -41,33 +48,48 @@ struct Generator {
 
 const Generator generators[] = {
   { flatbuffers::GenerateBinary,   "-b", "binary",
-    flatbuffers::GeneratorOptions::kMAX,
+    flatbuffers::GeneratorOptions::kMAX, true,
     "Generate wire format binaries for any data definitions",
     flatbuffers::BinaryMakeRule },
   { flatbuffers::GenerateTextFile, "-t", "text",
-    flatbuffers::GeneratorOptions::kMAX,
+    flatbuffers::GeneratorOptions::kMAX, true,
     "Generate text output for any data definitions",
     flatbuffers::TextMakeRule },
   { flatbuffers::GenerateCPP,      "-c", "C++",
-    flatbuffers::GeneratorOptions::kMAX,
+    flatbuffers::GeneratorOptions::kMAX, false,
     "Generate C++ headers for tables/structs",
     flatbuffers::CPPMakeRule },
   { flatbuffers::GenerateGo,       "-g", "Go",
-    flatbuffers::GeneratorOptions::kGo,
+    flatbuffers::GeneratorOptions::kGo, false,
     "Generate Go files for tables/structs",
     flatbuffers::GeneralMakeRule },
   { flatbuffers::GenerateGeneral,  "-j", "Java",
-    flatbuffers::GeneratorOptions::kJava,
+    flatbuffers::GeneratorOptions::kJava, false,
     "Generate Java classes for tables/structs",
     flatbuffers::GeneralMakeRule },
   { flatbuffers::GenerateGeneral,  "-n", "C#",
-    flatbuffers::GeneratorOptions::kCSharp,
+    flatbuffers::GeneratorOptions::kCSharp, false,
     "Generate C# classes for tables/structs",
     flatbuffers::GeneralMakeRule },
 };
 
 const char *program_name = NULL;
 
+static std::string Extension(const std::string &filename) {
+  return filename.substr(flatbuffers::StripExtension(filename).length());
+}
+
+// Whether this input file is a schema rather than data, going by its name.
+static bool IsSchema(const std::string &filename) {
+  return Extension(filename) == ".fbs" || Extension(filename) == ".bfbs";
+}
+
+static std::string ErrorText(const char *err, const char *obj = nullptr) {
+  std::string text = std::string(program_name) + ": " + err;
+  if (obj) text += std::string(": ") + obj;
+  return text;
+}
+
 static void Error(const char *err, const char *obj, bool usage,
                   bool show_exe_name) {
   if (show_exe_name) printf("%s: ", program_name);
@@ -89,7 +111,21 @@ static void Error(const char *err, const char *obj, bool usage,
       "  --no-prefix     Don\'t prefix enum values with the enum type in C++.\n"
       "  --gen-includes  Generate include statements for included schemas the\n"
       "                  generated file depends on (C++).\n"
+      "  --bulk-verify   Verify all inline fields of a table at once in the\n"
+      "                  generated Verify() methods (C++).\n"
       "  --proto         Input is a .proto, translate to .fbs.\n"
+      "  --schema        Also write each .fbs FILE as a binary schema\n"
+      "                  (.bfbs), which loads faster when given as FILE.\n"
+      "  --jobs N        Convert data FILEs between two schema FILEs on N\n"
+      "                  threads. Ignored with -M and --proto.\n"
+      "  --text-threads N\n"
+      "                  Print vectors of over 1024 elements on N threads\n"
+      "                  when converting to text (-t).\n"
+      "  --stream        FILEs not ending in .fbs or .bfbs each hold a stream\n"
+      "                  of concatenated or newline delimited JSON objects,\n"
+      "                  converted one at a time into size prefixed binaries\n"
+      "                  stored back to back. A FILE of - converts stdin to\n"
+      "                  stdout.\n"
       "FILEs may depend on declarations in earlier files.\n"
       "FILEs after the -- must be binary flatbuffer format files.\n"
       "Output files are named using the base file name of the input,\n"
@@ -109,12 +145,15 @@ int main(int argc, const char *argv[]) {
   bool any_generator = false;
   bool print_make_rules = false;
   bool proto_mode = false;
+  bool stream_mode = false;
+  bool binary_schema = false;
+  int jobs = 1;
   std::vector<std::string> filenames;
   std::vector<const char *> include_directories;
   size_t binary_files_from = std::numeric_limits<size_t>::max();
   for (int argi = 1; argi < argc; argi++) {
     const char *arg = argv[argi];
-    if (arg[0] == '-') {
+    if (arg[0] == '-' && arg[1]) {  // A lone - is stdin, with --stream.
       if (filenames.size() && arg[1] != '-')
         Error("invalid option location", arg, true);
       std::string opt = arg;
@@ -130,11 +169,28 @@ int main(int argc, const char *argv[]) {
         opts.prefixed_enums = false;
       } else if(opt == "--gen-includes") {
         opts.include_dependence_headers = true;
+      } else if(opt == "--bulk-verify") {
+        opts.bulk_verify = true;
       } else if(opt == "--") {  // Separator between text and binary inputs.
         binary_files_from = filenames.size();
       } else if(opt == "--proto") {
         proto_mode = true;
         any_generator = true;
+      } else if(opt == "--stream") {
+        stream_mode = true;
+        any_generator = true;
+      } else if(opt == "--schema") {
+        binary_schema = true;
+        any_generator = true;
+      } else if(opt == "--jobs") {
+        if (++argi >= argc) Error("missing count following", arg, true);
+        jobs = atoi(argv[argi]);
+        if (jobs < 1) Error("invalid job count", argv[argi], true);
+      } else if(opt == "--text-threads") {
+        if (++argi >= argc) Error("missing count following", arg, true);
+        opts.num_threads = atoi(argv[argi]);
+        if (opts.num_threads < 1)
+          Error("invalid thread count", argv[argi], true);
       } else if(opt == "-M") {
         print_make_rules = true;
       } else {
@@ -158,50 +214,84 @@ int main(int argc, const char *argv[]) {
   if (!any_generator)
     Error("no options", "specify one of -c -g -j -t -b etc.", true);
 
-  // Now process the files:
-  flatbuffers::Parser parser(opts.strict_json, proto_mode);
-  for (auto file_it = filenames.begin();
-            file_it != filenames.end();
-          ++file_it) {
-      std::string contents;
-      if (!flatbuffers::LoadFile(file_it->c_str(), true, &contents))
-        Error("unable to load file", file_it->c_str());
-
-      bool is_binary = static_cast<size_t>(file_it - filenames.begin()) >=
-                       binary_files_from;
+  // Parses or loads a single input file into parser, and runs the enabled
+  // generators on it. Returns an error message, or an empty string.
+  // Only touches state passed in, such that it can be run concurrently on
+  // separate parsers.
+  auto process_file = [&](flatbuffers::Parser &parser, size_t file_index,
+                          flatbuffers::GeneratorOptions &opts,
+                          std::vector<const char *> &include_directories)
+                         -> std::string {
+      auto file_it = filenames.begin() + file_index;
+      bool is_binary = file_index >= binary_files_from;
+      std::string filebase = flatbuffers::StripPath(
+                               flatbuffers::StripExtension(*file_it));
+
+      if (stream_mode && !is_binary && !IsSchema(*file_it)) {
+        // Streams are read and written incrementally, so they can be much
+        // larger than would fit in memory.
+        bool ok;
+        if (*file_it == "-") {
+          ok = parser.ParseJsonStream(std::cin, std::cout);
+        } else {
+          std::ifstream in(file_it->c_str(), std::ifstream::binary);
+          if (!in.is_open())
+            return ErrorText("unable to load file", file_it->c_str());
+          flatbuffers::EnsureDirExists(output_path);
+          auto out_name = flatbuffers::BinaryFileName(parser, output_path,
+                                                      filebase);
+          std::ofstream out(out_name.c_str(), std::ofstream::binary);
+          if (!out.is_open())
+            return ErrorText("unable to write file", out_name.c_str());
+          ok = parser.ParseJsonStream(in, out, file_it->c_str());
+        }
+        return ok ? "" : parser.error_;
+      }
+
+      // Mapped rather than loaded, such that large inputs are not copied.
+      flatbuffers::MappedFile contents;
+      if (!contents.Open(file_it->c_str()))
+        return ErrorText("unable to load file", file_it->c_str());
+
       if (is_binary) {
         parser.builder_.Clear();
-        parser.builder_.PushBytes(
-          reinterpret_cast<const uint8_t *>(contents.c_str()),
-          contents.length());
+        parser.SetBinaryData(
+          reinterpret_cast<const uint8_t *>(contents.data()),
+          contents.size());
+      } else if (Extension(*file_it) == ".bfbs") {
+        if (!parser.Deserialize(
+               reinterpret_cast<const uint8_t *>(contents.data()),
+               contents.size(), file_it->c_str()))
+          return parser.error_;
       } else {
         auto local_include_directory = flatbuffers::StripFileName(*file_it);
         include_directories.push_back(local_include_directory.c_str());
         include_directories.push_back(nullptr);
-        if (!parser.Parse(contents.c_str(), &include_directories[0],
-                          file_it->c_str()))
-          Error(parser.error_.c_str(), nullptr, false, false);
+        bool ok = parser.Parse(contents.data(), &include_directories[0],
+                               file_it->c_str());
         include_directories.pop_back();
         include_directories.pop_back();
+        if (!ok) return parser.error_;
       }
 
-      std::string filebase = flatbuffers::StripPath(
-                               flatbuffers::StripExtension(*file_it));
-
+      // Code is generated from the definitions, which a parser sharing the
+      // schema of another does not hold itself.
+      const flatbuffers::Parser &schema = parser.GetSchema();
       for (size_t i = 0; i < num_generators; ++i) {
         opts.lang = generators[i].lang;
         if (generator_enabled[i]) {
+          auto &input = generators[i].outputs_data ? parser : schema;
           if (!print_make_rules) {
             flatbuffers::EnsureDirExists(output_path);
-            if (!generators[i].generate(parser, output_path, filebase, opts)) {
-              Error((std::string("Unable to generate ") +
-                     generators[i].lang_name +
-                     " for " +
-                     filebase).c_str());
+            if (!generators[i].generate(input, output_path, filebase, opts)) {
+              return ErrorText((std::string("Unable to generate ") +
+                                generators[i].lang_name +
+                                " for " +
+                                filebase).c_str());
             }
           } else {
             std::string make_rule = generators[i].make_rule(
-                parser, output_path, *file_it, opts);
+                input, output_path, *file_it, opts);
             if (!make_rule.empty())
               printf("%s\n", flatbuffers::WordWrap(
                   make_rule, 80, " ", " \\").c_str());
@@ -209,11 +299,80 @@ int main(int argc, const char *argv[]) {
         }
       }
 
-      if (proto_mode) GenerateFBS(parser, output_path, filebase, opts);
+      if (proto_mode) GenerateFBS(schema, output_path, filebase, opts);
+
+      if (binary_schema && Extension(*file_it) == ".fbs") {
+        flatbuffers::FlatBufferBuilder builder;
+        schema.Serialize(builder);
+        flatbuffers::EnsureDirExists(output_path);
+        auto schema_name = output_path + filebase + ".bfbs";
+        if (!flatbuffers::SaveFile(
+               schema_name.c_str(),
+               reinterpret_cast<const char *>(builder.GetBufferPointer()),
+               builder.GetSize(), true))
+          return ErrorText("unable to write file", schema_name.c_str());
+      }
 
       // We do not want to generate code for the definitions in this file
       // in any files coming up next.
       parser.MarkGenerated();
+      return "";
+  };
+
+  // Now process the files. Make rules and .proto files are done in order
+  // regardless of --jobs, as there is no data conversion to spread.
+  flatbuffers::Parser parser(opts.strict_json, proto_mode);
+  if (jobs <= 1 || print_make_rules || proto_mode) {
+    for (size_t i = 0; i < filenames.size(); i++) {
+      auto err = process_file(parser, i, opts, include_directories);
+      if (!err.empty()) Error(err.c_str(), nullptr, false, false);
+    }
+    return 0;
+  }
+
+  // Converting data files is independent between files, and only reads the
+  // schema, so each run of data files between two schema files is spread
+  // over worker threads, sharing the schemas processed before it. Schemas
+  // are processed in order on this thread, so every data file sees the same
+  // definitions as it would without --jobs.
+  for (size_t run_begin = 0; run_begin < filenames.size(); ) {
+    if (run_begin < binary_files_from && IsSchema(filenames[run_begin])) {
+      auto err = process_file(parser, run_begin, opts, include_directories);
+      if (!err.empty()) Error(err.c_str(), nullptr, false, false);
+      run_begin++;
+      continue;
+    }
+    auto run_end = run_begin + 1;
+    while (run_end < filenames.size() &&
+           !(run_end < binary_files_from && IsSchema(filenames[run_end])))
+      run_end++;
+    // Once a file fails, files after it are not started, as sequential
+    // processing would have stopped there. Files before it still are, since
+    // one of those may fail too, and it's the first error that's reported.
+    std::vector<std::string> errors(run_end - run_begin);
+    std::atomic<size_t> next_job(0);
+    std::atomic<size_t> first_error(errors.size());
+    auto worker = [&]() {
+      flatbuffers::Parser worker_parser(parser, opts.strict_json);
+      auto worker_opts = opts;
+      auto worker_include_directories = include_directories;
+      for (;;) {
+        auto job = next_job++;
+        if (job >= errors.size() || job > first_error) break;
+        errors[job] = process_file(worker_parser, run_begin + job,
+                                   worker_opts, worker_include_directories);
+        if (errors[job].empty()) continue;
+        auto first = first_error.load();
+        while (job < first && !first_error.compare_exchange_weak(first, job))
+          ;
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < jobs; i++) threads.push_back(std::thread(worker));
+    for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+    if (first_error < errors.size())
+      Error(errors[first_error].c_str(), nullptr, false, false);
+    run_begin = run_end;
   }
 
   return 0;
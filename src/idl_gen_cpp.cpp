@@ -189,6 +189,24 @@ static void GenEnum(const Parser &parser, EnumDef &enum_def,
       }
     }
     code_post += "    default: return false;\n  }\n}\n\n";
+
+    // Generate a function giving the upper bound on the serialized size of
+    // whatever this union holds, for the table MaxSerializedSize() functions.
+    signature = "inline size_t MaxSerializedSize" + enum_def.name +
+                "(const void *union_obj, " + enum_def.name + " type)";
+    code += signature + ";\n\n";
+    code_post += signature + " {\n  switch (type) {\n";
+    for (auto it = enum_def.vals.vec.begin();
+         it != enum_def.vals.vec.end();
+         ++it) {
+      auto &ev = **it;
+      if (!ev.value) continue;  // "NONE" holds nothing.
+      code_post += "    case " + GenEnumVal(enum_def, ev, opts);
+      code_post += ": return reinterpret_cast<const ";
+      code_post += WrapInNameSpace(parser, *ev.struct_def);
+      code_post += " *>(union_obj)->MaxSerializedSize();\n";
+    }
+    code_post += "    default: return 0;\n  }\n}\n\n";
   }
 }
 
@@ -267,19 +285,52 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
   }
   // Generate a verifier function that can check a buffer from an untrusted
   // source will never cause reads outside the buffer.
+  // With bulk_verify, inline fields are all checked at once against the
+  // table's size, from a table of field sizes indexed by field id; only
+  // required fields and those pointing elsewhere in the buffer are verified
+  // individually.
   code += "  bool Verify(flatbuffers::Verifier &verifier) const {\n";
-  code += "    return VerifyTableStart(verifier)";
+  std::vector<std::string> field_sizes;
+  if (opts.bulk_verify) {
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end();
+         ++it) {
+      auto &field = **it;
+      auto id = (field.value.offset - FieldIndexToOffset(0)) /
+                sizeof(voffset_t);
+      if (field_sizes.size() <= id) field_sizes.resize(id + 1, "0");
+      if (!field.deprecated)
+        field_sizes[id] = "sizeof(" + GenTypeSize(parser, field.value.type) +
+                          ")";
+    }
+  }
+  if (!opts.bulk_verify) {
+    code += "    return VerifyTableStart(verifier)";
+  } else if (field_sizes.empty()) {
+    code += "    return VerifyTableFields(verifier)";
+  } else {
+    code += "    static const flatbuffers::voffset_t field_sizes[] = {\n";
+    for (auto it = field_sizes.begin(); it != field_sizes.end(); ++it) {
+      code += "      " + *it;
+      if (it + 1 != field_sizes.end()) code += ",";
+      code += "\n";
+    }
+    code += "    };\n";
+    code += "    return VerifyTableFields(verifier, field_sizes)";
+  }
   std::string prefix = " &&\n           ";
   for (auto it = struct_def.fields.vec.begin();
        it != struct_def.fields.vec.end();
        ++it) {
     auto &field = **it;
     if (!field.deprecated) {
-      code += prefix + "VerifyField";
-      if (field.required) code += "Required";
-      code += "<" + GenTypeSize(parser, field.value.type);
-      code += ">(verifier, " + NumToString(field.value.offset);
-      code += " /* " + field.name + " */)";
+      if (field.required || !opts.bulk_verify) {
+        code += prefix + "VerifyField";
+        if (field.required) code += "Required";
+        code += "<" + GenTypeSize(parser, field.value.type);
+        code += ">(verifier, " + NumToString(field.value.offset);
+        code += " /* " + field.name + " */)";
+      }
       switch (field.value.type.base_type) {
         case BASE_TYPE_UNION:
           code += prefix + "Verify" + field.value.type.enum_def->name;
@@ -320,6 +371,78 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
   }
   code += prefix + "verifier.EndTable()";
   code += ";\n  }\n";
+
+  // Generate upper bounds on the serialized size of this table, by itself
+  // and including everything it refers to, for pre-sizing a builder with
+  // FlatBufferBuilder::Reserve(). The former counts every field (as if
+  // written with ForceDefaults) with worst case alignment padding, plus the
+  // vtable offset and the vtable.
+  size_t max_table_size = (sizeof(soffset_t) - 1) + sizeof(soffset_t) +
+    FieldIndexToOffset(static_cast<voffset_t>(struct_def.fields.vec.size()));
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (!field.deprecated) {
+      max_table_size += InlineAlignment(field.value.type) - 1 +
+                        InlineSize(field.value.type);
+    }
+  }
+  code += "  static size_t MaxTableSize() { return ";
+  code += NumToString(max_table_size) + "; }\n";
+  code += "  size_t MaxSerializedSize() const {\n";
+  code += "    size_t size = MaxTableSize();\n";
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (field.deprecated) continue;
+    auto &type = field.value.type;
+    auto get = field.name + "()";
+    switch (type.base_type) {
+      case BASE_TYPE_UNION:
+        code += "    if (" + get + ") size += MaxSerializedSize";
+        code += type.enum_def->name + "(" + get + ", ";
+        code += field.name + "_type());\n";
+        break;
+      case BASE_TYPE_STRUCT:
+        if (!type.struct_def->fixed) {
+          code += "    if (" + get + ") size += " + get;
+          code += "->MaxSerializedSize();\n";
+        }
+        break;
+      case BASE_TYPE_STRING:
+        code += "    if (" + get + ") size += flatbuffers::MaxStringSize(";
+        code += get + "->size());\n";
+        break;
+      case BASE_TYPE_VECTOR: {
+        auto element_type = type.VectorType();
+        // Strings and tables in the vector are counted one by one.
+        auto per_element = element_type.base_type == BASE_TYPE_STRING ||
+                           (element_type.base_type == BASE_TYPE_STRUCT &&
+                            !element_type.struct_def->fixed);
+        code += "    if (" + get + ")" + (per_element ? " {\n      " : " ");
+        code += "size += flatbuffers::MaxVectorSize(" + get + "->size(), ";
+        code += NumToString(InlineSize(element_type)) + ", ";
+        code += NumToString(InlineAlignment(element_type)) + ");\n";
+        if (per_element) {
+          code += "      for (flatbuffers::uoffset_t i = 0; i < " + get;
+          code += "->size(); i++)\n";
+          code += "        size += ";
+          if (element_type.base_type == BASE_TYPE_STRING) {
+            code += "flatbuffers::MaxStringSize(" + get + "->Get(i)->size());\n";
+          } else {
+            code += get + "->Get(i)->MaxSerializedSize();\n";
+          }
+          code += "    }\n";
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  code += "    return size;\n  }\n";
   code += "};\n\n";
 
   // Generate a builder struct, with methods of the form:
@@ -414,6 +537,66 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
     }
   }
   code += "  return builder_.Finish();\n}\n\n";
+
+  // Generate an upper bound on the size of what CreateX() and everything
+  // passed to it take up, for sizing a builder with Reserve() before
+  // building. It takes a parameter for each field CreateX() takes an offset
+  // for, in the same order: the length of a string or vector, and for
+  // vectors of strings or tables, also the bytes in all strings or the
+  // bounds of all tables, and the bound of a table or union.
+  std::vector<std::string> params;
+  std::string terms = "  return " + struct_def.name + "::MaxTableSize()";
+  auto add_term = [&](const std::string &term) {
+    terms += " +\n         " + term;
+  };
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (field.deprecated) continue;
+    auto &type = field.value.type;
+    switch (type.base_type) {
+      case BASE_TYPE_UNION:
+        params.push_back(field.name + "_size");
+        add_term(field.name + "_size");
+        break;
+      case BASE_TYPE_STRUCT:
+        if (!type.struct_def->fixed) {
+          params.push_back(field.name + "_size");
+          add_term(field.name + "_size");
+        }
+        break;
+      case BASE_TYPE_STRING:
+        params.push_back(field.name + "_length");
+        add_term("flatbuffers::MaxStringSize(" + field.name + "_length)");
+        break;
+      case BASE_TYPE_VECTOR: {
+        auto element_type = type.VectorType();
+        params.push_back(field.name + "_length");
+        add_term("flatbuffers::MaxVectorSize(" + field.name + "_length, " +
+                 NumToString(InlineSize(element_type)) + ", " +
+                 NumToString(InlineAlignment(element_type)) + ")");
+        if (element_type.base_type == BASE_TYPE_STRING) {
+          params.push_back(field.name + "_bytes");
+          add_term(field.name + "_length * flatbuffers::MaxStringSize(0)");
+          add_term(field.name + "_bytes");
+        } else if (element_type.base_type == BASE_TYPE_STRUCT &&
+                   !element_type.struct_def->fixed) {
+          params.push_back(field.name + "_size");
+          add_term(field.name + "_size");
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  code += "inline size_t Max" + struct_def.name + "Size(";
+  for (auto it = params.begin(); it != params.end(); ++it) {
+    code += (it == params.begin() ? "\n   " : ",\n   ");
+    code += "size_t " + *it + " = 0";
+  }
+  code += ") {\n" + terms + ";\n}\n\n";
 }
 
 static void GenPadding(const FieldDef &field, const std::function<void (int bits)> &f) {
@@ -662,6 +845,17 @@ std::string GenerateCPP(const Parser &parser,
               "return verifier.VerifyBuffer<";
       code += name + ">(); }\n\n";
 
+      // An upper bound on the size of a buffer holding a copy of a root.
+      size_t max_align = sizeof(largest_scalar_t);
+      for (auto it = parser.structs_.vec.begin();
+           it != parser.structs_.vec.end(); ++it) {
+        max_align = std::max(max_align, (**it).minalign);
+      }
+      code += "inline size_t " + name + "BufferMaxSize(const " + name;
+      code += " *root) { return root->MaxSerializedSize() + ";
+      code += "flatbuffers::MaxFinishSize(" + NumToString(max_align);
+      code += "); }\n\n";
+
       if (parser.file_identifier_.length()) {
         // Return the identifier
         code += "inline const char *" + name;
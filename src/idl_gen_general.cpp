@@ -901,11 +901,11 @@ bool GenerateBinary(const Parser &parser,
                     const std::string &path,
                     const std::string &file_name,
                     const GeneratorOptions & /*opts*/) {
-  return !parser.builder_.GetSize() ||
+  return !parser.GetBinarySize() ||
          flatbuffers::SaveFile(
            BinaryFileName(parser, path, file_name).c_str(),
-           reinterpret_cast<char *>(parser.builder_.GetBufferPointer()),
-           parser.builder_.GetSize(),
+           reinterpret_cast<const char *>(parser.GetBinaryData()),
+           parser.GetBinarySize(),
            true);
 }
 
@@ -913,7 +913,7 @@ std::string BinaryMakeRule(const Parser &parser,
                            const std::string &path,
                            const std::string &file_name,
                            const GeneratorOptions & /*opts*/) {
-  if (!parser.builder_.GetSize()) return "";
+  if (!parser.GetBinarySize()) return "";
   std::string filebase = flatbuffers::StripPath(
       flatbuffers::StripExtension(file_name));
   std::string make_rule = BinaryFileName(parser, path, filebase) + ": " +
@@ -20,11 +20,36 @@
 #include "flatbuffers/idl.h"
 #include "flatbuffers/util.h"
 
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define FLATBUFFERS_SSE2
+  #include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+  #include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
 namespace flatbuffers {
 
 static void GenStruct(const StructDef &struct_def, const Table *table,
                       int indent, const GeneratorOptions &opts,
-                      std::string *_text);
+                      TextSink *sink);
+
+// A sink that never fills up, so all text stays in its buffer.
+class StringTextSink : public TextSink {
+ public:
+  StringTextSink() : TextSink(std::numeric_limits<size_t>::max()) {}
+
+ protected:
+  bool Write(const char *, size_t) { return true; }
+};
 
 // If indentation is less than 0, that indicates we don't want any newlines
 // either.
@@ -38,8 +63,8 @@ int Indent(const GeneratorOptions &opts) {
 
 // Output an identifier with or without quotes depending on strictness.
 void OutputIdentifier(const std::string &name, const GeneratorOptions &opts,
-                      std::string *_text) {
-  std::string &text = *_text;
+                      TextSink *sink) {
+  std::string &text = sink->buffer;
   if (opts.strict_json) text += "\"";
   text += name;
   if (opts.strict_json) text += "\"";
@@ -51,26 +76,28 @@ void OutputIdentifier(const std::string &name, const GeneratorOptions &opts,
 template<typename T> void Print(T val, Type type, int /*indent*/,
                                 StructDef * /*union_sd*/,
                                 const GeneratorOptions &opts,
-                                std::string *_text) {
-  std::string &text = *_text;
+                                TextSink *sink) {
+  std::string &text = sink->buffer;
   if (type.enum_def && opts.output_enum_identifiers) {
     auto enum_val = type.enum_def->ReverseLookup(static_cast<int>(val));
     if (enum_val) {
-      OutputIdentifier(enum_val->name, opts, _text);
+      OutputIdentifier(enum_val->name, opts, sink);
       return;
     }
   }
-  text += NumToString(val);
+  char buf[kMaxNumChars];
+  text.append(buf, NumToChars(val, buf));
 }
 
-// Print a vector a sequence of JSON values, comma separated, wrapped in "[]".
-template<typename T> void PrintVector(const Vector<T> &v, Type type,
-                                      int indent, const GeneratorOptions &opts,
-                                      std::string *_text) {
-  std::string &text = *_text;
-  text += "[";
-  text += NewLine(opts);
-  for (uoffset_t i = 0; i < v.size(); i++) {
+// Print elements [begin, end) of a vector, each preceded by indentation and,
+// after the first element of the vector, a separator.
+template<typename T> void PrintVectorElements(const Vector<T> &v, Type type,
+                                              uoffset_t begin, uoffset_t end,
+                                              int indent,
+                                              const GeneratorOptions &opts,
+                                              TextSink *sink) {
+  std::string &text = sink->buffer;
+  for (uoffset_t i = begin; i < end; i++) {
     if (i) {
       text += ",";
       text += NewLine(opts);
@@ -78,20 +105,132 @@ template<typename T> void PrintVector(const Vector<T> &v, Type type,
     text.append(indent + Indent(opts), ' ');
     if (IsStruct(type))
       Print(v.GetStructFromOffset(i * type.struct_def->bytesize), type,
-            indent + Indent(opts), nullptr, opts, _text);
+            indent + Indent(opts), nullptr, opts, sink);
     else
       Print(v.Get(i), type, indent + Indent(opts), nullptr,
-            opts, _text);
+            opts, sink);
+    sink->Check();
   }
+}
+
+// Elements each thread prints at a time when printing a vector in parallel.
+static const uoffset_t kElementsPerThread = 1024;
+
+// Print the elements of a large vector on opts.num_threads threads, started
+// once for the whole vector. The vector is cut into blocks of
+// kElementsPerThread elements, which thread t prints every num_threads-th
+// of, starting at block t, each into a buffer of its own. A thread then
+// waits for its turn to append the block to the sink, before printing its
+// next one, so memory use stays bounded and the text is the same as
+// printing sequentially. Vectors nested in the elements are printed
+// sequentially.
+template<typename T> void PrintVectorInParallel(const Vector<T> &v, Type type,
+                                                int indent,
+                                                const GeneratorOptions &opts,
+                                                TextSink *sink) {
+  auto num_threads = static_cast<size_t>(opts.num_threads);
+  auto num_blocks = static_cast<size_t>(
+    (v.size() + kElementsPerThread - 1) / kElementsPerThread);
+  auto worker_opts = opts;
+  worker_opts.num_threads = 1;
+  std::mutex mutex;
+  std::condition_variable turn_taken;
+  size_t turn = 0;  // The block to be appended to the sink next.
+  RunOnThreads(std::min(num_threads, num_blocks), [&](size_t t) {
+    StringTextSink block_sink;
+    for (auto block = t; block < num_blocks; block += num_threads) {
+      auto begin = static_cast<uoffset_t>(block) * kElementsPerThread;
+      auto end = std::min(v.size(), begin + kElementsPerThread);
+      PrintVectorElements(v, type, begin, end, indent, worker_opts,
+                          &block_sink);
+      std::unique_lock<std::mutex> lock(mutex);
+      turn_taken.wait(lock, [&]() { return turn == block; });
+      sink->buffer += block_sink.buffer;
+      sink->Check();
+      turn++;
+      turn_taken.notify_all();
+      block_sink.buffer.clear();
+    }
+  });
+}
+
+// Print a vector a sequence of JSON values, comma separated, wrapped in "[]".
+template<typename T> void PrintVector(const Vector<T> &v, Type type,
+                                      int indent, const GeneratorOptions &opts,
+                                      TextSink *sink) {
+  std::string &text = sink->buffer;
+  text += "[";
+  text += NewLine(opts);
+  if (opts.num_threads > 1 && v.size() > kElementsPerThread)
+    PrintVectorInParallel(v, type, indent, opts, sink);
+  else
+    PrintVectorElements(v, type, 0, v.size(), indent, opts, sink);
   text += NewLine(opts);
   text.append(indent, ' ');
   text += "]";
 }
 
-static void EscapeString(const String &s, std::string *_text) {
-  std::string &text = *_text;
+// Whether c can be output as-is inside a JSON string: printable ASCII other
+// than the quote and backslash.
+static bool IsPlain(char c) {
+  return c >= ' ' && c <= '~' && c != '\"' && c != '\\';
+}
+
+#if defined(FLATBUFFERS_SSE2) || defined(__AVX2__)
+static size_t LowestSetBit(uint32_t mask) {
+  #ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+  #else
+    return static_cast<size_t>(__builtin_ctz(mask));
+  #endif
+}
+#endif
+
+// Returns how many characters at the start of s are plain, checking 32 or
+// 16 at a time where the CPU allows, since strings are mostly plain text.
+// Bytes of 0x80 and up compare as negative, so the "< ' '" comparisons
+// catch those as well as control characters.
+static size_t PlainLength(const char *s, size_t len) {
+  size_t i = 0;
+  #ifdef __AVX2__
+    for (; i + 32 <= len; i += 32) {
+      auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+      auto special = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(' '), v),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7F))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))));
+      auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+      if (mask) return i + LowestSetBit(mask);
+    }
+  #endif
+  #ifdef FLATBUFFERS_SSE2
+    for (; i + 16 <= len; i += 16) {
+      auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+      auto special = _mm_or_si128(
+        _mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8(' ')),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+      if (mask) return i + LowestSetBit(mask);
+    }
+  #endif
+  while (i < len && IsPlain(s[i])) i++;
+  return i;
+}
+
+static void EscapeString(const String &s, TextSink *sink) {
+  std::string &text = sink->buffer;
   text += "\"";
   for (uoffset_t i = 0; i < s.size(); i++) {
+    // Copy plain text in bulk, up to the next character to escape.
+    auto plain = PlainLength(s.c_str() + i, s.size() - i);
+    text.append(s.c_str() + i, plain);
+    i += static_cast<uoffset_t>(plain);
+    if (i == s.size()) break;
     char c = s.Get(i);
     switch (c) {
       case '\n': text += "\\n"; break;
@@ -101,27 +240,24 @@ static void EscapeString(const String &s, std::string *_text) {
       case '\f': text += "\\f"; break;
       case '\"': text += "\\\""; break;
       case '\\': text += "\\\\"; break;
-      default:
-        if (c >= ' ' && c <= '~') {
-          text += c;
+      default: {
+        // Not printable ASCII data. Let's see if it's valid UTF-8 first:
+        const char *utf8 = s.c_str() + i;
+        int ucc = FromUTF8(&utf8);
+        if (ucc >= 0x80 && ucc <= 0xFFFF) {
+          // Parses as Unicode within JSON's \uXXXX range, so use that.
+          text += "\\u";
+          text += IntToStringHex(ucc, 4);
+          // Skip past characters recognized.
+          i = static_cast<uoffset_t>(utf8 - s.c_str() - 1);
         } else {
-          // Not printable ASCII data. Let's see if it's valid UTF-8 first:
-          const char *utf8 = s.c_str() + i;
-          int ucc = FromUTF8(&utf8);
-          if (ucc >= 0x80 && ucc <= 0xFFFF) {
-            // Parses as Unicode within JSON's \uXXXX range, so use that.
-            text += "\\u";
-            text += IntToStringHex(ucc, 4);
-            // Skip past characters recognized.
-            i = static_cast<uoffset_t>(utf8 - s.c_str() - 1);
-          } else {
-            // It's either unprintable ASCII, arbitrary binary, or Unicode data
-            // that doesn't fit \uXXXX, so use \xXX escape code instead.
-            text += "\\x";
-            text += IntToStringHex(static_cast<uint8_t>(c), 2);
-          }
+          // It's either unprintable ASCII, arbitrary binary, or Unicode data
+          // that doesn't fit \uXXXX, so use \xXX escape code instead.
+          text += "\\x";
+          text += IntToStringHex(static_cast<uint8_t>(c), 2);
         }
         break;
+      }
     }
   }
   text += "\"";
@@ -132,7 +268,7 @@ template<> void Print<const void *>(const void *val,
                                     Type type, int indent,
                                     StructDef *union_sd,
                                     const GeneratorOptions &opts,
-                                    std::string *_text) {
+                                    TextSink *sink) {
   switch (type.base_type) {
     case BASE_TYPE_UNION:
       // If this assert hits, you have an corrupt buffer, a union type field
@@ -142,17 +278,17 @@ template<> void Print<const void *>(const void *val,
                 reinterpret_cast<const Table *>(val),
                 indent,
                 opts,
-                _text);
+                sink);
       break;
     case BASE_TYPE_STRUCT:
       GenStruct(*type.struct_def,
                 reinterpret_cast<const Table *>(val),
                 indent,
                 opts,
-                _text);
+                sink);
       break;
     case BASE_TYPE_STRING: {
-      EscapeString(*reinterpret_cast<const String *>(val), _text);
+      EscapeString(*reinterpret_cast<const String *>(val), sink);
       break;
     }
     case BASE_TYPE_VECTOR:
@@ -163,7 +299,7 @@ template<> void Print<const void *>(const void *val,
           case BASE_TYPE_ ## ENUM: \
             PrintVector<CTYPE>( \
               *reinterpret_cast<const Vector<CTYPE> *>(val), \
-              type, indent, opts, _text); break;
+              type, indent, opts, sink); break;
           FLATBUFFERS_GEN_TYPES(FLATBUFFERS_TD)
         #undef FLATBUFFERS_TD
       }
@@ -177,17 +313,17 @@ template<typename T> static void GenField(const FieldDef &fd,
                                           const Table *table, bool fixed,
                                           const GeneratorOptions &opts,
                                           int indent,
-                                          std::string *_text) {
+                                          TextSink *sink) {
   Print(fixed ?
     reinterpret_cast<const Struct *>(table)->GetField<T>(fd.value.offset) :
     table->GetField<T>(fd.value.offset, 0), fd.value.type, indent, nullptr,
-                                            opts, _text);
+                                            opts, sink);
 }
 
 // Generate text for non-scalar field.
 static void GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
                            int indent, StructDef *union_sd,
-                           const GeneratorOptions &opts, std::string *_text) {
+                           const GeneratorOptions &opts, TextSink *sink) {
   const void *val = nullptr;
   if (fixed) {
     // The only non-scalar fields in structs are structs.
@@ -199,15 +335,15 @@ static void GenFieldOffset(const FieldDef &fd, const Table *table, bool fixed,
       ? table->GetStruct<const void *>(fd.value.offset)
       : table->GetPointer<const void *>(fd.value.offset);
   }
-  Print(val, fd.value.type, indent, union_sd, opts, _text);
+  Print(val, fd.value.type, indent, union_sd, opts, sink);
 }
 
 // Generate text for a struct or table, values separated by commas, indented,
 // and bracketed by "{}"
 static void GenStruct(const StructDef &struct_def, const Table *table,
                       int indent, const GeneratorOptions &opts,
-                      std::string *_text) {
-  std::string &text = *_text;
+                      TextSink *sink) {
+  std::string &text = sink->buffer;
   text += "{";
   int fieldout = 0;
   StructDef *union_sd = nullptr;
@@ -222,13 +358,13 @@ static void GenStruct(const StructDef &struct_def, const Table *table,
       }
       text += NewLine(opts);
       text.append(indent + Indent(opts), ' ');
-      OutputIdentifier(fd.name, opts, _text);
+      OutputIdentifier(fd.name, opts, sink);
       text += ": ";
       switch (fd.value.type.base_type) {
          #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
            case BASE_TYPE_ ## ENUM: \
               GenField<CTYPE>(fd, table, struct_def.fixed, \
-                              opts, indent + Indent(opts), _text); \
+                              opts, indent + Indent(opts), sink); \
               break;
           FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD)
         #undef FLATBUFFERS_TD
@@ -238,7 +374,7 @@ static void GenStruct(const StructDef &struct_def, const Table *table,
           FLATBUFFERS_GEN_TYPES_POINTER(FLATBUFFERS_TD)
         #undef FLATBUFFERS_TD
             GenFieldOffset(fd, table, struct_def.fixed, indent + Indent(opts),
-                           union_sd, opts, _text);
+                           union_sd, opts, sink);
             break;
       }
       if (fd.value.type.base_type == BASE_TYPE_UTYPE) {
@@ -247,6 +383,7 @@ static void GenStruct(const StructDef &struct_def, const Table *table,
         assert(enum_val);
         union_sd = enum_val->struct_def;
       }
+      sink->Check();
     }
   }
   text += NewLine(opts);
@@ -256,16 +393,24 @@ static void GenStruct(const StructDef &struct_def, const Table *table,
 
 // Generate a text representation of a flatbuffer in JSON format.
 void GenerateText(const Parser &parser, const void *flatbuffer,
-                  const GeneratorOptions &opts, std::string *_text) {
-  std::string &text = *_text;
+                  const GeneratorOptions &opts, TextSink *sink) {
   assert(parser.root_struct_def);  // call SetRootType()
-  text.reserve(1024);   // Reduce amount of inevitable reallocs.
   GenStruct(*parser.root_struct_def,
             GetRoot<Table>(flatbuffer),
             0,
             opts,
-            _text);
-  text += NewLine(opts);
+            sink);
+  sink->buffer += NewLine(opts);
+  sink->Check();
+}
+
+void GenerateText(const Parser &parser, const void *flatbuffer,
+                  const GeneratorOptions &opts, std::string *_text) {
+  StringTextSink sink;
+  sink.buffer.swap(*_text);  // Append to any existing text.
+  sink.buffer.reserve(1024);   // Reduce amount of inevitable reallocs.
+  GenerateText(parser, flatbuffer, opts, &sink);
+  sink.buffer.swap(*_text);
 }
 
 std::string TextFileName(const std::string &path,
@@ -277,20 +422,21 @@ bool GenerateTextFile(const Parser &parser,
                       const std::string &path,
                       const std::string &file_name,
                       const GeneratorOptions &opts) {
-  if (!parser.builder_.GetSize() || !parser.root_struct_def) return true;
-  std::string text;
-  GenerateText(parser, parser.builder_.GetBufferPointer(), opts,
-               &text);
-  return flatbuffers::SaveFile(TextFileName(path, file_name).c_str(),
-                               text,
-                               false);
+  if (!parser.GetBinarySize() || !parser.root_struct_def) return true;
+  // Stream the text to the file, rather than building it all in memory.
+  FILE *file = fopen(TextFileName(path, file_name).c_str(), "w");
+  if (!file) return false;
+  FileTextSink sink(file);
+  GenerateText(parser, parser.GetBinaryData(), opts, &sink);
+  auto ok = sink.Flush();
+  return fclose(file) == 0 && ok;
 }
 
 std::string TextMakeRule(const Parser &parser,
                          const std::string &path,
                          const std::string &file_name,
                          const GeneratorOptions & /*opts*/) {
-  if (!parser.builder_.GetSize() || !parser.root_struct_def) return "";
+  if (!parser.GetBinarySize() || !parser.root_struct_def) return "";
   std::string filebase = flatbuffers::StripPath(
       flatbuffers::StripExtension(file_name));
   std::string make_rule = TextFileName(path, filebase) + ": " + file_name;
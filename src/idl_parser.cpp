@@ -15,11 +15,14 @@
  */
 
 #include <algorithm>
+#include <istream>
 #include <list>
+#include <ostream>
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/hash.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/reflection_generated.h"
 #include "flatbuffers/util.h"
 
 namespace flatbuffers {
@@ -51,24 +54,26 @@ static void CheckBitsFit(int64_t val, size_t bits) {
     Error("constant does not fit in a " + NumToString(bits) + "-bit field");
 }
 
-// atot: templated version of atoi/atof: convert a string to an instance of T.
-template<typename T> inline T atot(const char *s) {
-  auto val = StringToInt(s);
-  CheckBitsFit(val, sizeof(T) * 8);
-  return (T)val;
+// Decode the text of a scalar constant into e, according to its type.
+static void DecodeScalar(Value &e, const char *s) {
+  if (IsFloat(e.type.base_type)) e.f = strtod(s, nullptr);
+  else e.i = StringToInt(s);
 }
-template<> inline bool atot<bool>(const char *s) {
-  return 0 != atoi(s);
+
+// valtot: get the value held by a Value (see Value::i) as an instance of T.
+template<typename T> inline T valtot(const Value &v) {
+  CheckBitsFit(v.i, sizeof(T) * 8);
+  return (T)v.i;
 }
-template<> inline float atot<float>(const char *s) {
-  return static_cast<float>(strtod(s, nullptr));
+template<> inline float valtot<float>(const Value &v) {
+  return static_cast<float>(v.f);
 }
-template<> inline double atot<double>(const char *s) {
-  return strtod(s, nullptr);
+template<> inline double valtot<double>(const Value &v) {
+  return v.f;
 }
 
-template<> inline Offset<void> atot<Offset<void>>(const char *s) {
-  return Offset<void>(atoi(s));
+template<> inline Offset<void> valtot<Offset<void>>(const Value &v) {
+  return Offset<void>(v.o);
 }
 
 // Declare tokens we'll use. Single character tokens are represented by their
@@ -120,6 +125,72 @@ static std::string TokenToString(int t) {
   }
 }
 
+// Identifiers with a special meaning, and the tokens they turn into: type
+// names, boolean constants (see Parser::Next) and the declaration keywords.
+struct Keyword {
+  const char *name;
+  int token;
+};
+
+static const Keyword kKeywords[] = {
+  #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
+    { IDLTYPE, kToken ## ENUM },
+    FLATBUFFERS_GEN_TYPES(FLATBUFFERS_TD)
+  #undef FLATBUFFERS_TD
+  { "true", kTokenIntegerConstant },
+  { "false", kTokenIntegerConstant },
+  // Only the tokens from kTokenTable onwards are keywords.
+  #define FLATBUFFERS_TOKEN(NAME, VALUE, STRING) \
+    { VALUE >= kTokenTable ? STRING : "", kToken ## NAME },
+    FLATBUFFERS_GEN_TOKENS(FLATBUFFERS_TOKEN)
+  #undef FLATBUFFERS_TOKEN
+};
+
+// Classifies identifiers as keywords without comparing against each of them
+// in turn. Keywords are hashed on their length and first and last character,
+// which is enough to give each its own slot, so lookups are a single compare.
+class KeywordTable {
+ public:
+  KeywordTable() {
+    memset(slots_, 0, sizeof(slots_));
+    for (size_t i = 0; i < sizeof(kKeywords) / sizeof(kKeywords[0]); i++) {
+      auto &kw = kKeywords[i];
+      if (!*kw.name) continue;  // Not something that can be written.
+      auto len = strlen(kw.name);
+      auto slot = Hash(kw.name, len);
+      while (slots_[slot].name) slot = (slot + 1) & (kNumSlots - 1);
+      Slot s = { kw.name, len, kw.token };
+      slots_[slot] = s;
+    }
+  }
+
+  // Returns the token for this identifier, kTokenIdentifier if not a keyword.
+  int Lookup(const char *name, size_t len) const {
+    for (auto slot = Hash(name, len); slots_[slot].name;
+         slot = (slot + 1) & (kNumSlots - 1)) {
+      if (slots_[slot].len == len && !memcmp(slots_[slot].name, name, len))
+        return slots_[slot].token;
+    }
+    return kTokenIdentifier;
+  }
+
+ private:
+  static const size_t kNumSlots = 64;
+
+  static size_t Hash(const char *name, size_t len) {
+    return (static_cast<unsigned char>(name[0]) * 3 +
+            static_cast<unsigned char>(name[len - 1]) * 31 + len) &
+           (kNumSlots - 1);
+  }
+
+  struct Slot {
+    const char *name;
+    size_t len;
+    int token;
+  };
+  Slot slots_[kNumSlots];
+};
+
 // Parses exactly nibbles worth of hex digits into a number, or error.
 int64_t Parser::ParseHexNum(int nibbles) {
   for (int i = 0; i < nibbles; i++)
@@ -149,35 +220,38 @@ void Parser::Next() {
         Error("floating point constant can\'t start with \".\"");
         break;
       case '\"':
-        attribute_ = "";
+        attribute_.clear();
         while (*cursor_ != '\"') {
-          if (*cursor_ < ' ' && *cursor_ >= 0)
-            Error("illegal character in string constant");
-          if (*cursor_ == '\\') {
+          // Copy runs of characters that need no unescaping in one go.
+          const char *run = cursor_;
+          while (*cursor_ != '\"' && *cursor_ != '\\' &&
+                 (*cursor_ >= ' ' || *cursor_ < 0))
             cursor_++;
-            switch (*cursor_) {
-              case 'n':  attribute_ += '\n'; cursor_++; break;
-              case 't':  attribute_ += '\t'; cursor_++; break;
-              case 'r':  attribute_ += '\r'; cursor_++; break;
-              case 'b':  attribute_ += '\b'; cursor_++; break;
-              case 'f':  attribute_ += '\f'; cursor_++; break;
-              case '\"': attribute_ += '\"'; cursor_++; break;
-              case '\\': attribute_ += '\\'; cursor_++; break;
-              case '/':  attribute_ += '/';  cursor_++; break;
-              case 'x': {  // Not in the JSON standard
-                cursor_++;
-                attribute_ += static_cast<char>(ParseHexNum(2));
-                break;
-              }
-              case 'u': {
-                cursor_++;
-                ToUTF8(static_cast<int>(ParseHexNum(4)), &attribute_);
-                break;
-              }
-              default: Error("unknown escape code in string constant"); break;
+          attribute_.append(run, cursor_);
+          if (*cursor_ == '\"') break;
+          if (*cursor_ != '\\')
+            Error("illegal character in string constant");
+          cursor_++;
+          switch (*cursor_) {
+            case 'n':  attribute_ += '\n'; cursor_++; break;
+            case 't':  attribute_ += '\t'; cursor_++; break;
+            case 'r':  attribute_ += '\r'; cursor_++; break;
+            case 'b':  attribute_ += '\b'; cursor_++; break;
+            case 'f':  attribute_ += '\f'; cursor_++; break;
+            case '\"': attribute_ += '\"'; cursor_++; break;
+            case '\\': attribute_ += '\\'; cursor_++; break;
+            case '/':  attribute_ += '/';  cursor_++; break;
+            case 'x': {  // Not in the JSON standard
+              cursor_++;
+              attribute_ += static_cast<char>(ParseHexNum(2));
+              break;
+            }
+            case 'u': {
+              cursor_++;
+              ToUTF8(static_cast<int>(ParseHexNum(4)), &attribute_);
+              break;
             }
-          } else { // printable chars + UTF-8 bytes
-            attribute_ += *cursor_++;
+            default: Error("unknown escape code in string constant"); break;
           }
         }
         cursor_++;
@@ -202,42 +276,14 @@ void Parser::Next() {
           while (isalnum(static_cast<unsigned char>(*cursor_)) ||
                  *cursor_ == '_')
             cursor_++;
-          attribute_.clear();
-          attribute_.append(start, cursor_);
-          // First, see if it is a type keyword from the table of types:
-          #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
-            if (attribute_ == IDLTYPE) { \
-              token_ = kToken ## ENUM; \
-              return; \
-            }
-            FLATBUFFERS_GEN_TYPES(FLATBUFFERS_TD)
-          #undef FLATBUFFERS_TD
+          attribute_.assign(start, cursor_);
+          // See if it is a keyword, otherwise it is a user-defined identifier:
+          static const KeywordTable keywords;
+          token_ = keywords.Lookup(start, cursor_ - start);
           // If it's a boolean constant keyword, turn those into integers,
           // which simplifies our logic downstream.
-          if (attribute_ == "true" || attribute_ == "false") {
-            attribute_ = NumToString(attribute_ == "true");
-            token_ = kTokenIntegerConstant;
-            return;
-          }
-          // Check for declaration keywords:
-          if (attribute_ == "table")     { token_ = kTokenTable;     return; }
-          if (attribute_ == "struct")    { token_ = kTokenStruct;    return; }
-          if (attribute_ == "enum")      { token_ = kTokenEnum;      return; }
-          if (attribute_ == "union")     { token_ = kTokenUnion;     return; }
-          if (attribute_ == "namespace") { token_ = kTokenNameSpace; return; }
-          if (attribute_ == "root_type") { token_ = kTokenRootType;  return; }
-          if (attribute_ == "include")   { token_ = kTokenInclude;   return; }
-          if (attribute_ == "attribute") { token_ = kTokenAttribute; return; }
-          if (attribute_ == "file_identifier") {
-            token_ = kTokenFileIdentifier;
-            return;
-          }
-          if (attribute_ == "file_extension") {
-            token_ = kTokenFileExtension;
-            return;
-          }
-          // If not, it is a user-defined identifier:
-          token_ = kTokenIdentifier;
+          if (token_ == kTokenIntegerConstant)
+            attribute_.assign(1, *start == 't' ? '1' : '0');
           return;
         } else if (isdigit(static_cast<unsigned char>(c)) || c == '-') {
           const char *start = cursor_ - 1;
@@ -377,15 +423,14 @@ void Parser::ParseField(StructDef &struct_def) {
     Next();
     if (!IsScalar(type.base_type))
       Error("default values currently only supported for scalars");
-    ParseSingleValue(field.value);
+    ParseSingleValue(field.value, true);
   }
 
   if (type.enum_def &&
       IsScalar(type.base_type) &&
       !struct_def.fixed &&
       !type.enum_def->attributes.Lookup("bit_flags") &&
-      !type.enum_def->ReverseLookup(static_cast<int>(
-                         StringToInt(field.value.constant.c_str()))))
+      !type.enum_def->ReverseLookup(static_cast<int>(field.value.i)))
     Error("enum " + type.enum_def->name +
           " does not have a declaration for this field\'s default of " +
           field.value.constant);
@@ -466,25 +511,24 @@ void Parser::ParseAnyValue(Value &val, FieldDef *field) {
       if (!field_stack_.size() ||
           field_stack_.back().second->value.type.base_type != BASE_TYPE_UTYPE)
         Error("missing type field before this union value: " + field->name);
-      auto enum_idx = atot<unsigned char>(
-                                    field_stack_.back().first.constant.c_str());
+      auto enum_idx = valtot<unsigned char>(field_stack_.back().first);
       auto enum_val = val.type.enum_def->ReverseLookup(enum_idx);
       if (!enum_val) Error("illegal type id for: " + field->name);
-      val.constant = NumToString(ParseTable(*enum_val->struct_def));
+      val.o = ParseTable(*enum_val->struct_def);
       break;
     }
     case BASE_TYPE_STRUCT:
-      val.constant = NumToString(ParseTable(*val.type.struct_def));
+      val.o = ParseTable(*val.type.struct_def);
       break;
     case BASE_TYPE_STRING: {
-      auto s = attribute_;
+      if (token_ == kTokenStringConstant)  // Else Expect() errors below.
+        val.o = builder_.CreateString(attribute_).o;
       Expect(kTokenStringConstant);
-      val.constant = NumToString(builder_.CreateString(s).o);
       break;
     }
     case BASE_TYPE_VECTOR: {
       Expect('[');
-      val.constant = NumToString(ParseVector(val.type.VectorType()));
+      val.o = ParseVector(val.type.VectorType());
       break;
     }
     case BASE_TYPE_INT:
@@ -495,103 +539,102 @@ void Parser::ParseAnyValue(Value &val, FieldDef *field) {
           (token_ == kTokenIdentifier || token_ == kTokenStringConstant)) {
         ParseHash(val, field);
       } else {
-        ParseSingleValue(val);
+        ParseSingleValue(val, false);
       }
       break;
     }
     default:
-      ParseSingleValue(val);
+      ParseSingleValue(val, false);
       break;
   }
 }
 
 void Parser::SerializeStruct(const StructDef &struct_def, const Value &val) {
-  auto off = atot<uoffset_t>(val.constant.c_str());
-  assert(struct_stack_.size() - off == struct_def.bytesize);
+  auto off = val.o;
+  assert(off + struct_def.bytesize <= struct_stack_.size());
   builder_.Align(struct_def.minalign);
   builder_.PushBytes(&struct_stack_[off], struct_def.bytesize);
-  struct_stack_.resize(struct_stack_.size() - struct_def.bytesize);
   builder_.AddStructOffset(val.offset, builder_.GetSize());
 }
 
 uoffset_t Parser::ParseTable(const StructDef &struct_def) {
   Expect('{');
+  // The values of this object go on field_stack_ in the order they appear,
+  // and each field's slot records where (+1, 0 for absent).
+  auto slots = slot_stack_.size();
+  slot_stack_.resize(slots + struct_def.fields.vec.size(), 0);
+  // Where the structs this object contains will be kept, until serialized.
+  auto structs = struct_stack_.size();
   size_t fieldn = 0;
   for (;;) {
     if ((!strict_json_ || !fieldn) && IsNext('}')) break;
-    std::string name = attribute_;
-    if (!IsNext(kTokenStringConstant))
+    // Look up the field while the name is still in attribute_, rather than
+    // copying it.
+    if (token_ != kTokenStringConstant &&
+        (strict_json_ || token_ != kTokenIdentifier))
       Expect(strict_json_ ? kTokenStringConstant : kTokenIdentifier);
-    auto field = struct_def.fields.Lookup(name);
-    if (!field) Error("unknown field: " + name);
+    auto field = struct_def.fields.Lookup(attribute_);
+    if (!field) Error("unknown field: " + attribute_);
     if (struct_def.fixed && (fieldn >= struct_def.fields.vec.size()
                             || struct_def.fields.vec[fieldn] != field)) {
-       Error("struct field appearing out of order: " + name);
+       Error("struct field appearing out of order: " + field->name);
     }
+    if (slot_stack_[slots + field->slot])
+      Error("field set more than once: " + field->name);
+    Next();
     Expect(':');
     Value val = field->value;
     ParseAnyValue(val, field);
-    field_stack_.push_back(std::make_pair(val, field));
+    field_stack_.push_back(std::make_pair(std::move(val), field));
+    slot_stack_[slots + field->slot] = field_stack_.size();
     fieldn++;
     if (IsNext('}')) break;
     Expect(',');
   }
-  for (auto it = field_stack_.rbegin();
-           it != field_stack_.rbegin() + fieldn; ++it) {
-    if (it->second->used)
-      Error("field set more than once: " + it->second->name);
-    it->second->used = true;
-  }
-  for (auto it = field_stack_.rbegin();
-           it != field_stack_.rbegin() + fieldn; ++it) {
-    it->second->used = false;
-  }
   if (struct_def.fixed && fieldn != struct_def.fields.vec.size())
     Error("incomplete struct initialization: " + struct_def.name);
   auto start = struct_def.fixed
                  ? builder_.StartStruct(struct_def.minalign)
                  : builder_.StartTable();
 
-  for (size_t size = struct_def.sortbysize ? sizeof(largest_scalar_t) : 1;
-       size;
-       size /= 2) {
-    // Go through elements in reverse, since we're building the data backwards.
-    for (auto it = field_stack_.rbegin();
-             it != field_stack_.rbegin() + fieldn; ++it) {
-      auto &value = it->first;
-      auto field = it->second;
-      if (!struct_def.sortbysize || size == SizeOf(value.type.base_type)) {
-        switch (value.type.base_type) {
-          #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
-            case BASE_TYPE_ ## ENUM: \
-              builder_.Pad(field->padding); \
-              if (struct_def.fixed) { \
-                builder_.PushElement(atot<CTYPE>(value.constant.c_str())); \
-              } else { \
-                builder_.AddElement(value.offset, \
-                             atot<CTYPE>(       value.constant.c_str()), \
-                             atot<CTYPE>(field->value.constant.c_str())); \
-              } \
-              break;
-            FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD);
-          #undef FLATBUFFERS_TD
-          #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
-            case BASE_TYPE_ ## ENUM: \
-              builder_.Pad(field->padding); \
-              if (IsStruct(field->value.type)) { \
-                SerializeStruct(*field->value.type.struct_def, value); \
-              } else { \
-                builder_.AddOffset(value.offset, \
-                  atot<CTYPE>(value.constant.c_str())); \
-              } \
-              break;
-            FLATBUFFERS_GEN_TYPES_POINTER(FLATBUFFERS_TD);
-          #undef FLATBUFFERS_TD
-        }
-      }
+  // Write the fields present in a single pass, in the order planned for
+  // this struct (independent of the order they appear in).
+  for (auto it = struct_def.serialize_order.begin();
+           it != struct_def.serialize_order.end(); ++it) {
+    auto field = *it;
+    auto index = slot_stack_[slots + field->slot];
+    if (!index) continue;
+    auto &value = field_stack_[index - 1].first;
+    switch (value.type.base_type) {
+      #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
+        case BASE_TYPE_ ## ENUM: \
+          builder_.Pad(field->padding); \
+          if (struct_def.fixed) { \
+            builder_.PushElement(valtot<CTYPE>(value)); \
+          } else { \
+            builder_.AddElement(value.offset, \
+                                valtot<CTYPE>(value), \
+                                valtot<CTYPE>(field->value)); \
+          } \
+          break;
+        FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD);
+      #undef FLATBUFFERS_TD
+      #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
+        case BASE_TYPE_ ## ENUM: \
+          builder_.Pad(field->padding); \
+          if (IsStruct(field->value.type)) { \
+            SerializeStruct(*field->value.type.struct_def, value); \
+          } else { \
+            builder_.AddOffset(value.offset, valtot<CTYPE>(value)); \
+          } \
+          break;
+        FLATBUFFERS_GEN_TYPES_POINTER(FLATBUFFERS_TD);
+      #undef FLATBUFFERS_TD
     }
   }
   for (size_t i = 0; i < fieldn; i++) field_stack_.pop_back();
+  slot_stack_.resize(slots);
+  struct_stack_.resize(structs);
 
   if (struct_def.fixed) {
     builder_.ClearOffsets();
@@ -612,13 +655,14 @@ uoffset_t Parser::ParseTable(const StructDef &struct_def) {
 }
 
 uoffset_t Parser::ParseVector(const Type &type) {
+  auto structs = struct_stack_.size();
   int count = 0;
   for (;;) {
     if ((!strict_json_ || !count) && IsNext(']')) break;
     Value val;
     val.type = type;
     ParseAnyValue(val, nullptr);
-    field_stack_.push_back(std::make_pair(val, nullptr));
+    field_stack_.push_back(std::make_pair(std::move(val), nullptr));
     count++;
     if (IsNext(']')) break;
     Expect(',');
@@ -633,13 +677,14 @@ uoffset_t Parser::ParseVector(const Type &type) {
       #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
         case BASE_TYPE_ ## ENUM: \
           if (IsStruct(val.type)) SerializeStruct(*val.type.struct_def, val); \
-          else builder_.PushElement(atot<CTYPE>(val.constant.c_str())); \
+          else builder_.PushElement(valtot<CTYPE>(val)); \
           break;
         FLATBUFFERS_GEN_TYPES(FLATBUFFERS_TD)
       #undef FLATBUFFERS_TD
     }
     field_stack_.pop_back();
   }
+  struct_stack_.resize(structs);
 
   builder_.ClearOffsets();
   return builder_.EndVector(count);
@@ -655,7 +700,7 @@ void Parser::ParseMetaData(Definition &def) {
       auto e = new Value();
       def.attributes.Add(name, e);
       if (IsNext(':')) {
-        ParseSingleValue(*e);
+        ParseSingleValue(*e, true);
       }
       if (IsNext(')')) break;
       Expect(',');
@@ -666,10 +711,11 @@ void Parser::ParseMetaData(Definition &def) {
 bool Parser::TryTypedValue(int dtoken,
                            bool check,
                            Value &e,
-                           BaseType req) {
+                           BaseType req,
+                           bool keep_text) {
   bool match = dtoken == token_;
   if (match) {
-    e.constant = attribute_;
+    if (keep_text) e.constant = attribute_;
     if (!check) {
       if (e.type.base_type == BASE_TYPE_NONE) {
         e.type.base_type = req;
@@ -680,6 +726,7 @@ bool Parser::TryTypedValue(int dtoken,
               kTypeNames[req]);
       }
     }
+    if (IsScalar(e.type.base_type)) DecodeScalar(e, attribute_.c_str());
     Next();
   }
   return match;
@@ -688,35 +735,31 @@ bool Parser::TryTypedValue(int dtoken,
 int64_t Parser::ParseIntegerFromString(Type &type) {
   int64_t result = 0;
   // Parse one or more enum identifiers, separated by spaces.
+  // Names are looked up in place, strings are only made for errors.
   const char *next = attribute_.c_str();
   do {
-    const char *divider = strchr(next, ' ');
-    std::string word;
-    if (divider) {
-      word = std::string(next, divider);
-      next = divider + strspn(divider, " ");
-    } else {
-      word = next;
-      next += word.length();
-    }
+    const char *word = next;
+    size_t word_len = strcspn(word, " ");
+    next = word + word_len;
+    next += strspn(next, " ");
     if (type.enum_def) {  // The field has an enum type
-      auto enum_val = type.enum_def->vals.Lookup(word);
+      auto enum_val = type.enum_def->vals.Lookup(word, word_len);
       if (!enum_val)
-        Error("unknown enum value: " + word +
+        Error("unknown enum value: " + std::string(word, word_len) +
               ", for enum: " + type.enum_def->name);
       result |= enum_val->value;
     } else {  // No enum type, probably integral field.
       if (!IsInteger(type.base_type))
-        Error("not a valid value for this field: " + word);
+        Error("not a valid value for this field: " +
+              std::string(word, word_len));
       // TODO: could check if its a valid number constant here.
-      const char *dot = strchr(word.c_str(), '.');
+      auto dot = static_cast<const char *>(memchr(word, '.', word_len));
       if (!dot) Error("enum values need to be qualified by an enum type");
-      std::string enum_def_str(word.c_str(), dot);
-      std::string enum_val_str(dot + 1, word.c_str() + word.length());
-      auto enum_def = enums_.Lookup(enum_def_str);
-      if (!enum_def) Error("unknown enum: " + enum_def_str);
-      auto enum_val = enum_def->vals.Lookup(enum_val_str);
-      if (!enum_val) Error("unknown enum value: " + enum_val_str);
+      auto enum_def = schema_->enums_.Lookup(word, dot - word);
+      if (!enum_def) Error("unknown enum: " + std::string(word, dot));
+      auto enum_val = enum_def->vals.Lookup(dot + 1, word + word_len - dot - 1);
+      if (!enum_val)
+        Error("unknown enum value: " + std::string(dot + 1, word + word_len));
       result |= enum_val->value;
     }
   } while(*next);
@@ -732,14 +775,14 @@ void Parser::ParseHash(Value &e, FieldDef* field) {
     case BASE_TYPE_UINT: {
       auto hash = FindHashFunction32(hash_name->constant.c_str());
       uint32_t hashed_value = hash(attribute_.c_str());
-      e.constant = NumToString(hashed_value);
+      e.i = hashed_value;
       break;
     }
     case BASE_TYPE_LONG:
     case BASE_TYPE_ULONG: {
       auto hash = FindHashFunction64(hash_name->constant.c_str());
       uint64_t hashed_value = hash(attribute_.c_str());
-      e.constant = NumToString(hashed_value);
+      e.i = static_cast<int64_t>(hashed_value);
       break;
     }
     default:
@@ -748,25 +791,31 @@ void Parser::ParseHash(Value &e, FieldDef* field) {
   Next();
 }
 
-void Parser::ParseSingleValue(Value &e) {
+// Parses a value into e, also keeping its text in e.constant if keep_text
+// (for schema values, which code generators need as text).
+void Parser::ParseSingleValue(Value &e, bool keep_text) {
   // First check if this could be a string/identifier enum value:
   if (e.type.base_type != BASE_TYPE_STRING &&
       e.type.base_type != BASE_TYPE_NONE &&
       (token_ == kTokenIdentifier || token_ == kTokenStringConstant)) {
-      e.constant = NumToString(ParseIntegerFromString(e.type));
+      e.i = ParseIntegerFromString(e.type);
+      if (keep_text) e.constant = NumToString(e.i);
       Next();
   } else if (TryTypedValue(kTokenIntegerConstant,
                     IsScalar(e.type.base_type),
                     e,
-                    BASE_TYPE_INT) ||
+                    BASE_TYPE_INT,
+                    keep_text) ||
       TryTypedValue(kTokenFloatConstant,
                     IsFloat(e.type.base_type),
                     e,
-                    BASE_TYPE_FLOAT) ||
+                    BASE_TYPE_FLOAT,
+                    keep_text) ||
       TryTypedValue(kTokenStringConstant,
                     e.type.base_type == BASE_TYPE_STRING,
                     e,
-                    BASE_TYPE_STRING)) {
+                    BASE_TYPE_STRING,
+                    keep_text)) {
   } else {
     Error("cannot parse value starting with: " + TokenToString(token_));
   }
@@ -947,11 +996,12 @@ void Parser::ParseDecl() {
   CheckClash("Type", BASE_TYPE_UNION);
   CheckClash("_length", BASE_TYPE_VECTOR);
   CheckClash("Length", BASE_TYPE_VECTOR);
+  struct_def.PlanSerialization();
   Expect('}');
 }
 
 bool Parser::SetRootType(const char *name) {
-  root_struct_def = structs_.Lookup(name);
+  root_struct_def = schema_->structs_.Lookup(name);
   return root_struct_def != nullptr;
 }
 
@@ -1032,11 +1082,14 @@ void Parser::ParseProtoDecl() {
         Next();
         Expect('=');
         field.value.constant = attribute_;
+        if (IsScalar(type.base_type))
+          DecodeScalar(field.value, attribute_.c_str());
         Next();
         Expect(']');
       }
       Expect(';');
     }
+    struct_def.PlanSerialization();
     Next();
   } else if (attribute_ == "enum") {
     // These are almost the same, just with different terminator:
@@ -1103,10 +1156,11 @@ bool Parser::Parse(const char *source, const char **include_paths,
   line_ = 1;
   error_.clear();
   builder_.Clear();
+  binary_data_ = nullptr;
   try {
     Next();
     // Includes must come first:
-    while (IsNext(kTokenInclude)) {
+    while (schema_ == this && IsNext(kTokenInclude)) {
       auto name = attribute_;
       Expect(kTokenStringConstant);
       // Look for the file in include_paths.
@@ -1122,29 +1176,34 @@ bool Parser::Parse(const char *source, const char **include_paths,
       if (included_files_.find(filepath) == included_files_.end()) {
         // We found an include file that we have not parsed yet.
         // Load it and parse it.
-        std::string contents;
-        if (!LoadFile(filepath.c_str(), true, &contents))
+        MappedFile contents;
+        if (!contents.Open(filepath.c_str()))
           Error("unable to load include file: " + name);
-        if (!Parse(contents.c_str(), include_paths, filepath.c_str())) {
+        // Parsing it overwrites the lexer state, so save ours to continue
+        // this file right after the include statement. This way each file
+        // is only tokenized once.
+        auto saved_source = source_;
+        auto saved_cursor = cursor_;
+        auto saved_line = line_;
+        auto saved_token = token_;
+        if (!Parse(contents.data(), include_paths, filepath.c_str())) {
           // Any errors, we're done.
           return false;
         }
+        source_ = saved_source;
+        cursor_ = saved_cursor;
+        line_ = saved_line;
+        token_ = saved_token;
         // We do not want to output code for any included files:
         MarkGenerated();
-        // This is the easiest way to continue this file after an include:
-        // instead of saving and restoring all the state, we simply start the
-        // file anew. This will cause it to encounter the same include statement
-        // again, but this time it will skip it, because it was entered into
-        // included_files_.
-        // This is recursive, but only go as deep as the number of include
-        // statements.
-        return Parse(source, include_paths, source_filename);
       }
       Expect(';');
     }
     // Now parse all other kinds of declarations:
     while (token_ != kTokenEof) {
-      if (proto_mode_) {
+      if (schema_ != this && token_ != '{' && token_ != kTokenRootType) {
+        Error("a parser sharing a schema can only parse json and root_type");
+      } else if (proto_mode_) {
         ParseProtoDecl();
       } else if (token_ == kTokenNameSpace) {
         ParseNamespace();
@@ -1212,14 +1271,7 @@ bool Parser::Parse(const char *source, const char **include_paths,
       }
     }
   } catch (const std::string &msg) {
-    error_ = source_filename ? AbsolutePath(source_filename) : "";
-    #ifdef _WIN32
-      error_ += "(" + NumToString(line_) + ")";  // MSVC alike
-    #else
-      if (source_filename) error_ += ":";
-      error_ += NumToString(line_) + ":0";  // gcc alike
-    #endif
-    error_ += ": error: " + msg;
+    SetError(msg, source_filename);
     if (source_filename) files_being_parsed_.pop();
     return false;
   }
@@ -1228,6 +1280,135 @@ bool Parser::Parse(const char *source, const char **include_paths,
   return true;
 }
 
+void Parser::SetError(const std::string &msg, const char *source_filename) {
+  error_ = source_filename ? AbsolutePath(source_filename) : "";
+  #ifdef _WIN32
+    error_ += "(" + NumToString(line_) + ")";  // MSVC alike
+  #else
+    if (source_filename) error_ += ":";
+    error_ += NumToString(line_) + ":0";  // gcc alike
+  #endif
+  error_ += ": error: " + msg;
+}
+
+// Finds where each top level JSON object in a stream ends, without
+// tokenizing it, such that the stream can be cut up into records before
+// they are parsed. Strings and comments are skipped, since they may contain
+// braces. Any other character outside of an object makes up a record of its
+// own, for the parser to report. Since the state is kept between calls, an
+// object that arrives in pieces is only scanned once.
+class JsonRecordScanner {
+ public:
+  JsonRecordScanner() { Reset(); }
+
+  void Reset() {
+    depth_ = 0;
+    in_string_ = in_comment_ = escaped_ = false;
+  }
+
+  // Scan buf from *pos up to end. Returns true if a record ends in there,
+  // with *pos just past it. Otherwise *pos is where to resume once more
+  // data has been appended to buf.
+  bool Scan(const char *buf, size_t *pos, size_t end) {
+    for (auto i = *pos; i < end; i++) {
+      auto c = buf[i];
+      if (in_comment_) {
+        if (c == '\n' || c == '\r') in_comment_ = false;
+      } else if (in_string_) {
+        if (escaped_) escaped_ = false;
+        else if (c == '\\') escaped_ = true;
+        else if (c == '\"') in_string_ = false;
+      } else if (c == '/' && i + 1 == end) {
+        *pos = i;  // Need the next character to tell if this is a comment.
+        return false;
+      } else if (c == '/' && buf[i + 1] == '/') {
+        in_comment_ = true;
+        i++;
+      } else if (c == '{' || c == '[') {
+        depth_++;
+      } else if (depth_) {
+        if (c == '\"') in_string_ = true;
+        else if ((c == '}' || c == ']') && !--depth_) {
+          *pos = i + 1;
+          return true;
+        }
+      } else if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+        *pos = i + 1;
+        return true;
+      }
+    }
+    *pos = end;
+    return false;
+  }
+
+  // Whether a record was started but not finished by the data scanned.
+  bool InRecord() const { return depth_ > 0; }
+
+ private:
+  int depth_;
+  bool in_string_, in_comment_, escaped_;
+};
+
+void Parser::ParseJsonRecord(const char *record) {
+  source_ = cursor_ = record;
+  builder_.Clear();
+  Next();
+  builder_.FinishSizePrefixed(Offset<Table>(ParseTable(*root_struct_def)),
+    file_identifier_.length() ? file_identifier_.c_str() : nullptr);
+  Expect(kTokenEof);
+}
+
+bool Parser::ParseJsonStream(std::istream &in, std::ostream &out,
+                             const char *source_filename) {
+  line_ = 1;  // Counted across records, for errors.
+  error_.clear();
+  binary_data_ = nullptr;
+  try {
+    if (!root_struct_def) Error("no root type set to parse json with");
+    // Holds the records not yet parsed: the one being read, and whichever
+    // followed it in the last chunk read.
+    std::string buf;
+    size_t start = 0;  // Where the current record starts in buf.
+    size_t pos = 0;    // How far buf has been scanned.
+    JsonRecordScanner scanner;
+    auto convert = [&](size_t end) {
+      // The lexer expects a terminator, so temporarily cut the record off.
+      auto c = end < buf.size() ? buf[end] : '\0';
+      if (c) buf[end] = '\0';
+      ParseJsonRecord(&buf[start]);
+      if (c) buf[end] = c;
+      out.write(reinterpret_cast<const char *>(builder_.GetBufferPointer()),
+                builder_.GetSize());
+      if (!out) Error("unable to write output");
+      start = end;
+    };
+    for (;;) {
+      while (scanner.Scan(buf.c_str(), &pos, buf.size())) {
+        convert(pos);
+        scanner.Reset();
+      }
+      // Drop the records done with, then append the next chunk.
+      buf.erase(0, start);
+      pos -= start;
+      start = 0;
+      static const size_t kChunkSize = 1 << 16;
+      auto size = buf.size();
+      buf.resize(size + kChunkSize);
+      in.read(&buf[size], kChunkSize);
+      buf.resize(size + static_cast<size_t>(in.gcount()));
+      if (in.bad()) Error("unable to read input");
+      if (buf.size() == size) break;
+    }
+    // Anything left over is a truncated record, for which we want the
+    // parser's error.
+    if (scanner.InRecord() || pos < buf.size()) convert(buf.size());
+  } catch (const std::string &msg) {
+    SetError(msg, source_filename);
+    return false;
+  }
+  return true;
+}
+
 std::set<std::string> Parser::GetIncludedFilesRecursive(
     const std::string &file_name) const {
   std::set<std::string> included_files;
@@ -1251,4 +1432,333 @@ std::set<std::string> Parser::GetIncludedFilesRecursive(
   return included_files;
 }
 
+// Binary schemas: see reflection/reflection.fbs.
+
+static_assert(static_cast<int>(reflection::BaseType_Obj) == BASE_TYPE_STRUCT &&
+              static_cast<int>(reflection::BaseType_Union) == BASE_TYPE_UNION,
+              "reflection::BaseType must match BaseType");
+
+typedef Offset<Vector<Offset<reflection::KeyValue>>> AttributesOffset;
+typedef Offset<Vector<Offset<String>>> NamespaceOffset;
+
+// Attributes are stored in the order they were declared in. Symbol tables
+// only map names to values, so each one's name is found among the names
+// known.
+static AttributesOffset SerializeAttributes(
+    FlatBufferBuilder &builder, const SymbolTable<Value> &attributes,
+    const std::set<std::string> &known_attributes) {
+  if (attributes.vec.empty()) return 0;
+  std::vector<Offset<reflection::KeyValue>> attrs;
+  for (auto it = attributes.vec.begin(); it != attributes.vec.end(); ++it) {
+    for (auto name_it = known_attributes.begin();
+         name_it != known_attributes.end(); ++name_it) {
+      if (attributes.Lookup(*name_it) != *it) continue;
+      attrs.push_back(reflection::CreateKeyValue(
+        builder,
+        builder.CreateSharedString(*name_it),
+        builder.CreateSharedString((*it)->constant)));
+      break;
+    }
+  }
+  return builder.CreateVector(attrs);
+}
+
+static NamespaceOffset SerializeNamespace(FlatBufferBuilder &builder,
+                                          const Namespace *ns) {
+  if (!ns || ns->components.empty()) return 0;
+  std::vector<Offset<String>> components;
+  for (auto it = ns->components.begin(); it != ns->components.end(); ++it) {
+    components.push_back(builder.CreateSharedString(*it));
+  }
+  return builder.CreateVector(components);
+}
+
+void Parser::Serialize(FlatBufferBuilder &builder) const {
+  std::map<const StructDef *, int> struct_indices;
+  std::map<const EnumDef *, int> enum_indices;
+  for (size_t i = 0; i < structs_.vec.size(); i++)
+    struct_indices[structs_.vec[i]] = static_cast<int>(i);
+  for (size_t i = 0; i < enums_.vec.size(); i++)
+    enum_indices[enums_.vec[i]] = static_cast<int>(i);
+  // Types repeat a lot, so are stored once each, as are names below.
+  std::map<std::vector<int>, Offset<reflection::Type>> types;
+  auto serialize_type = [&](const Type &type) {
+    std::vector<int> key(4);
+    key[0] = type.base_type;
+    key[1] = type.element;
+    key[2] = type.struct_def ? struct_indices[type.struct_def] : -1;
+    key[3] = type.enum_def ? enum_indices[type.enum_def] : -1;
+    auto &offset = types[key];
+    if (!offset.o) {
+      offset = reflection::CreateType(builder,
+                                      static_cast<reflection::BaseType>(key[0]),
+                                      static_cast<reflection::BaseType>(key[1]),
+                                      key[2], key[3]);
+    }
+    return offset;
+  };
+
+  std::vector<Offset<reflection::Object>> objects;
+  for (auto it = structs_.vec.begin(); it != structs_.vec.end(); ++it) {
+    auto &struct_def = **it;
+    std::vector<Offset<reflection::Field>> fields;
+    for (auto field_it = struct_def.fields.vec.begin();
+         field_it != struct_def.fields.vec.end(); ++field_it) {
+      auto &field = **field_it;
+      auto &value = field.value;
+      auto base_type = value.type.base_type;
+      fields.push_back(reflection::CreateField(
+        builder,
+        builder.CreateSharedString(field.name),
+        serialize_type(value.type),
+        value.offset,
+        IsInteger(base_type) ? value.i : 0,
+        IsFloat(base_type) ? value.f : 0,
+        value.constant != "0" ? builder.CreateSharedString(value.constant) : 0,
+        field.deprecated,
+        field.required,
+        field.key,
+        static_cast<uint32_t>(field.padding),
+        SerializeAttributes(builder, field.attributes, known_attributes_)));
+    }
+    objects.push_back(reflection::CreateObject(
+      builder,
+      builder.CreateString(struct_def.name),
+      SerializeNamespace(builder, struct_def.defined_namespace),
+      builder.CreateVector(fields),
+      struct_def.fixed,
+      struct_def.sortbysize,
+      struct_def.has_key,
+      static_cast<int32_t>(struct_def.minalign),
+      static_cast<int32_t>(struct_def.bytesize),
+      SerializeAttributes(builder, struct_def.attributes, known_attributes_),
+      struct_def.generated));
+  }
+
+  std::vector<Offset<reflection::Enum>> enums;
+  for (auto it = enums_.vec.begin(); it != enums_.vec.end(); ++it) {
+    auto &enum_def = **it;
+    std::vector<Offset<reflection::EnumVal>> vals;
+    for (auto val_it = enum_def.vals.vec.begin();
+         val_it != enum_def.vals.vec.end(); ++val_it) {
+      auto &val = **val_it;
+      vals.push_back(reflection::CreateEnumVal(
+        builder,
+        builder.CreateSharedString(val.name),
+        val.value,
+        val.struct_def ? struct_indices[val.struct_def] : -1));
+    }
+    enums.push_back(reflection::CreateEnum(
+      builder,
+      builder.CreateString(enum_def.name),
+      SerializeNamespace(builder, enum_def.defined_namespace),
+      builder.CreateVector(vals),
+      enum_def.is_union,
+      serialize_type(enum_def.underlying_type),
+      SerializeAttributes(builder, enum_def.attributes, known_attributes_),
+      enum_def.generated));
+  }
+
+  reflection::FinishSchemaBuffer(builder, reflection::CreateSchema(
+    builder,
+    builder.CreateVector(objects),
+    builder.CreateVector(enums),
+    file_identifier_.length() ? builder.CreateString(file_identifier_) : 0,
+    file_extension_.length() ? builder.CreateString(file_extension_) : 0,
+    root_struct_def ? struct_indices[root_struct_def] : -1));
+}
+
+bool Parser::Deserialize(const uint8_t *buf, size_t size,
+                         const char *source_filename) {
+  error_.clear();
+  line_ = 0;  // Errors have no line to refer to.
+  try {
+    // Nothing is read from the buffer before it has been verified in full.
+    Verifier verifier(buf, size);
+    if (!reflection::VerifySchemaBuffer(verifier))
+      Error("binary schema failed verification");
+    if (!reflection::SchemaBufferHasIdentifier(buf))
+      Error("not a binary schema");
+    auto schema = reflection::GetSchema(buf);
+    auto objects = schema->objects();
+    auto enums = schema->enums();
+
+    // Create all definitions up front, since they refer to each other by
+    // index.
+    std::vector<StructDef *> struct_defs;
+    std::vector<EnumDef *> enum_defs;
+    structs_.Reserve(structs_.vec.size() + objects->size());
+    enums_.Reserve(enums_.vec.size() + enums->size());
+    for (auto it = objects->begin(); it != objects->end(); ++it) {
+      auto name = it->name()->str();
+      auto struct_def = new StructDef();
+      if (structs_.Add(name, struct_def))
+        Error("datatype already exists: " + name);
+      struct_def->name = name;
+      struct_defs.push_back(struct_def);
+    }
+    for (auto it = enums->begin(); it != enums->end(); ++it) {
+      auto name = it->name()->str();
+      auto enum_def = new EnumDef();
+      if (enums_.Add(name, enum_def)) Error("enum already exists: " + name);
+      enum_def->name = name;
+      enum_defs.push_back(enum_def);
+    }
+
+    auto lookup_struct = [&](int index) -> StructDef * {
+      if (index < 0) return nullptr;
+      if (static_cast<size_t>(index) >= struct_defs.size())
+        Error("datatype index out of range");
+      return struct_defs[index];
+    };
+    auto deserialize_type = [&](const reflection::Type *type) {
+      if (type->base_type() > reflection::BaseType_Union ||
+          type->element() > reflection::BaseType_Union)
+        Error("unknown base type");
+      Type result(static_cast<BaseType>(type->base_type()),
+                  lookup_struct(type->struct_index()));
+      result.element = static_cast<BaseType>(type->element());
+      if (type->enum_index() >= 0) {
+        if (static_cast<size_t>(type->enum_index()) >= enum_defs.size())
+          Error("enum index out of range");
+        result.enum_def = enum_defs[type->enum_index()];
+      }
+      if ((result.base_type == BASE_TYPE_STRUCT ||
+           result.element == BASE_TYPE_STRUCT) && !result.struct_def)
+        Error("struct type without definition");
+      if (result.base_type == BASE_TYPE_UNION && !result.enum_def)
+        Error("union type without definition");
+      return result;
+    };
+    auto deserialize_namespace = [&](const Vector<Offset<String>> *names) {
+      std::vector<std::string> components;
+      if (names) {
+        for (auto it = names->begin(); it != names->end(); ++it)
+          components.push_back(it->str());
+      }
+      for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
+        if ((*it)->components == components) return *it;
+      }
+      auto ns = new Namespace();
+      ns->components = components;
+      namespaces_.push_back(ns);
+      return ns;
+    };
+    auto deserialize_attributes = [&](
+        const Vector<Offset<reflection::KeyValue>> *attrs,
+        SymbolTable<Value> &attributes) {
+      if (!attrs) return;
+      for (auto it = attrs->begin(); it != attrs->end(); ++it) {
+        auto value = new Value();
+        attributes.Add(it->key()->str(), value);
+        if (it->value()) value->constant = it->value()->str();
+        known_attributes_.insert(it->key()->str());
+      }
+    };
+
+    for (uoffset_t i = 0; i < objects->size(); i++) {
+      auto object = objects->Get(i);
+      auto &struct_def = *struct_defs[i];
+      struct_def.fields.Reserve(object->fields()->size());
+      for (auto it = object->fields()->begin();
+           it != object->fields()->end(); ++it) {
+        auto name = it->name()->str();
+        auto &field = *new FieldDef();
+        if (struct_def.fields.Add(name, &field))
+          Error("field already exists: " + name);
+        field.name = name;
+        field.value.type = deserialize_type(it->type());
+        field.value.offset = it->offset();
+        if (it->default_text())
+          field.value.constant = it->default_text()->str();
+        if (IsInteger(field.value.type.base_type))
+          field.value.i = it->default_integer();
+        else if (IsFloat(field.value.type.base_type))
+          field.value.f = it->default_real();
+        field.deprecated = it->deprecated() != 0;
+        field.required = it->required() != 0;
+        field.key = it->key() != 0;
+        field.padding = it->padding();
+        deserialize_attributes(it->attributes(), field.attributes);
+      }
+      struct_def.fixed = object->is_struct() != 0;
+      struct_def.predecl = false;
+      struct_def.sortbysize = object->sortbysize() != 0;
+      struct_def.has_key = object->has_key() != 0;
+      struct_def.minalign = object->minalign();
+      struct_def.bytesize = object->bytesize();
+      struct_def.generated = object->generated() != 0;
+      struct_def.defined_namespace =
+        deserialize_namespace(object->defined_namespace());
+      deserialize_attributes(object->attributes(), struct_def.attributes);
+      struct_def.PlanSerialization();
+    }
+    // The layout of structs and the vtable slots of tables are used as is
+    // when serializing, so must be checked before anything relies on them.
+    for (auto it = struct_defs.begin(); it != struct_defs.end(); ++it) {
+      auto &struct_def = **it;
+      auto &fields = struct_def.fields.vec;
+      if (!struct_def.fixed) {
+        auto end = FieldIndexToOffset(static_cast<voffset_t>(fields.size()));
+        for (auto field_it = fields.begin(); field_it != fields.end();
+             ++field_it) {
+          auto offset = (*field_it)->value.offset;
+          if (offset < FieldIndexToOffset(0) || offset >= end ||
+              offset % sizeof(voffset_t) || (*field_it)->padding)
+            Error("field has no valid vtable slot: " + (*field_it)->name);
+        }
+        continue;
+      }
+      auto minalign = struct_def.minalign;
+      if (!minalign || minalign & (minalign - 1) || minalign > 256 ||
+          struct_def.bytesize % minalign)
+        Error("struct has an invalid size or alignment: " + struct_def.name);
+      size_t size = 0;
+      for (auto field_it = fields.begin(); field_it != fields.end();
+           ++field_it) {
+        auto &field = **field_it;
+        if (!IsScalar(field.value.type.base_type) && !IsStruct(field.value.type))
+          Error("struct fields must be scalars or structs: " + field.name);
+        auto field_size = InlineSize(field.value.type);
+        if (field.value.offset + field_size > struct_def.bytesize ||
+            field.padding >= minalign)
+          Error("field lies outside its struct: " + field.name);
+        size += field_size + field.padding;
+      }
+      if (size != struct_def.bytesize)
+        Error("struct fields don't add up to its size: " + struct_def.name);
+    }
+    for (uoffset_t i = 0; i < enums->size(); i++) {
+      auto enum_ = enums->Get(i);
+      auto &enum_def = *enum_defs[i];
+      enum_def.vals.Reserve(enum_->values()->size());
+      for (auto it = enum_->values()->begin();
+           it != enum_->values()->end(); ++it) {
+        auto name = it->name()->str();
+        auto &val = *new EnumVal(name, it->value());
+        if (enum_def.vals.Add(name, &val))
+          Error("enum value already exists: " + name);
+        val.struct_def = lookup_struct(it->union_index());
+      }
+      enum_def.is_union = enum_->is_union() != 0;
+      enum_def.underlying_type = deserialize_type(enum_->underlying_type());
+      enum_def.generated = enum_->generated() != 0;
+      enum_def.defined_namespace =
+        deserialize_namespace(enum_->defined_namespace());
+      deserialize_attributes(enum_->attributes(), enum_def.attributes);
+    }
+
+    if (schema->root_table() >= 0) {
+      root_struct_def = lookup_struct(schema->root_table());
+      if (root_struct_def->fixed) Error("root type must be a table");
+    }
+    if (schema->file_ident()) file_identifier_ = schema->file_ident()->str();
+    if (schema->file_ext()) file_extension_ = schema->file_ext()->str();
+  } catch (const std::string &msg) {
+    SetError(msg, source_filename);
+    return false;
+  }
+  return true;
+}
+
 }  // namespace flatbuffers
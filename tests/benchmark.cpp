@@ -0,0 +1,531 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks for the parts of the library that are tuned for speed. These
+// are not run as part of the tests, since timings vary per machine.
+// Usage: flatbenchmark [max_threads]
+// Run from the root of the repository, like flattests. Multithreaded
+// benchmarks are run for 1, 2, 4, .. max_threads threads (by default, the
+// number of cores), to show how they scale.
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+
+#include "monster_test_generated.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <random>
+#include <thread>
+
+#ifdef _WIN32
+  #include <process.h>
+  #define getpid _getpid
+#endif
+
+// Every heap allocation made by this program, to count them per benchmark.
+static std::atomic<size_t> heap_allocations(0);
+
+// These replace new and delete, so GCC's check that memory from new isn't
+// given to free() doesn't apply.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+  #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size) {
+  heap_allocations++;
+  if (auto p = malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+// Runs f and returns how long it took, in seconds.
+template<typename F> double Time(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+void Report(const char *name, int threads, double bytes, double seconds) {
+  printf("%-24s %2d thread(s): %8.1f MB/s\n", name, threads,
+         bytes / seconds / (1024 * 1024));
+}
+
+bool LoadSchema(flatbuffers::Parser &parser) {
+  std::string schemafile;
+  const char *include_directories[] = { "tests", nullptr };
+  return flatbuffers::LoadFile("tests/monster_test.fbs", false,
+                               &schemafile) &&
+         parser.Parse(schemafile.c_str(), include_directories);
+}
+
+// Building many small buffers, one builder each, with the default allocator
+// and with a pool_allocator, which recycles the buffer memory.
+void SmallBuildersBenchmark() {
+  const int num_buffers = 1000000;
+  auto build = [](const flatbuffers::simple_allocator *allocator) {
+    flatbuffers::FlatBufferBuilder builder(1024, allocator);
+    auto name = builder.CreateString("small");
+    auto start = builder.StartTable();
+    builder.AddOffset(4, name);
+    builder.AddElement<int32_t>(6, 42, 0);
+    builder.Finish(flatbuffers::Offset<flatbuffers::Table>(
+                     builder.EndTable(start, 2)));
+  };
+  flatbuffers::pool_allocator pool;
+  const flatbuffers::simple_allocator *allocators[] = {
+    &flatbuffers::simple_allocator::default_instance(), &pool
+  };
+  const char *names[] = { "default allocator", "pool_allocator" };
+  for (int a = 0; a < 2; a++) {
+    auto before = heap_allocations.load();
+    auto seconds = Time([&]() {
+      for (int i = 0; i < num_buffers; i++) build(allocators[a]);
+    });
+    printf("%-24s %d builders: %8.3f s, %.2f heap allocations each\n",
+           names[a], num_buffers, seconds,
+           static_cast<double>(heap_allocations - before) / num_buffers);
+  }
+  flatbuffers::pool_allocator::trim();
+}
+
+// Building num_tables tables that each have a different vtable, from
+// different combinations of 17 byte fields. EndTable looks for an identical
+// earlier vtable to share, which should cost the same however many vtables
+// the buffer already holds.
+void VTableDedupBenchmark() {
+  const int num_fields = 17;
+  for (int num_tables = 1000; num_tables <= 100000; num_tables *= 10) {
+    flatbuffers::FlatBufferBuilder builder;
+    auto seconds = Time([&]() {
+      for (int i = 1; i <= num_tables; i++) {
+        auto start = builder.StartTable();
+        for (int field = 0; field < num_fields; field++) {
+          if (i & (1 << field)) {
+            builder.AddElement<int8_t>(
+              flatbuffers::FieldIndexToOffset(
+                static_cast<flatbuffers::voffset_t>(field)), 1, 0);
+          }
+        }
+        builder.EndTable(start, num_fields);
+      }
+    });
+    printf("vtable dedup %6d distinct vtables: %8.1f ns/table\n", num_tables,
+           seconds * 1e9 / num_tables);
+  }
+}
+
+// Building a buffer of 1M strings drawn from 300 distinct tags, with
+// CreateString (a copy each), CreateSharedString (one copy per tag), and
+// InternStrings(true). CreateString is also timed on a builder with
+// ChunkedStorage(), which grows without copying what was written so far.
+void SharedStringsBenchmark() {
+  const int num_strings = 1000000;
+  const int num_tags = 300;
+  std::vector<std::string> tags;
+  for (int i = 0; i < num_tags; i++)
+    tags.push_back("telemetry.tag.name." + flatbuffers::NumToString(i * 7919));
+  const char *names[] = {
+    "CreateString", "CreateSharedString", "InternStrings",
+    "CreateString, chunked"
+  };
+  for (int mode = 0; mode < 4; mode++) {
+    flatbuffers::FlatBufferBuilder builder;
+    if (mode == 3) builder.ChunkedStorage(64 * 1024);
+    builder.InternStrings(mode == 2);
+    auto seconds = Time([&]() {
+      for (int i = 0; i < num_strings; i++) {
+        auto &tag = tags[(i * 31) % num_tags];
+        if (mode == 1) builder.CreateSharedString(tag);
+        else builder.CreateString(tag);
+      }
+    });
+    printf("strings, %-22s %10u bytes, %6.1f ms\n", names[mode],
+           builder.GetSize(), seconds * 1e3);
+  }
+}
+
+// Creating a vector of 10M floats with CreateVector, which copies scalars
+// in bulk, and with the element by element loop it used before.
+void ScalarVectorBenchmark() {
+  const size_t num_elements = 10000000;
+  const int num_runs = 5;
+  std::vector<float> floats(num_elements);
+  for (size_t i = 0; i < num_elements; i++)
+    floats[i] = static_cast<float>(i) / 7;
+  flatbuffers::FlatBufferBuilder builder;
+  double bulk = 1e9, loop = 1e9;
+  for (int run = 0; run < num_runs; run++) {
+    builder.Clear();
+    bulk = std::min(bulk, Time([&]() {
+      builder.CreateVector(floats);
+    }));
+    builder.Clear();
+    loop = std::min(loop, Time([&]() {
+      builder.StartVector(num_elements, sizeof(float));
+      for (auto i = num_elements; i > 0; ) builder.PushElement(floats[--i]);
+      builder.EndVector(num_elements);
+    }));
+  }
+  printf("float vector: CreateVector %7.1f M elements/s, "
+         "element loop %7.1f M elements/s\n",
+         num_elements / bulk / 1e6, num_elements / loop / 1e6);
+}
+
+// Parsing many JSON files against one schema, like flatc --jobs does: each
+// thread has a parser sharing the schema, and takes the next file in turn.
+void ParseJsonBenchmark(int max_threads) {
+  flatbuffers::Parser schema;
+  std::string json;
+  if (!LoadSchema(schema) ||
+      !flatbuffers::LoadFile("tests/monsterdata_test.golden", false, &json)) {
+    printf("parse json: unable to load tests/monster_test.fbs\n");
+    return;
+  }
+  const size_t num_files = 20000;
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    std::atomic<size_t> next_file(0);
+    auto worker = [&]() {
+      flatbuffers::Parser parser(schema, false);
+      while (next_file++ < num_files) parser.Parse(json.c_str());
+    };
+    auto seconds = Time([&]() {
+      flatbuffers::RunOnThreads(threads, [&](size_t) { worker(); });
+    });
+    Report("parse json", threads,
+           static_cast<double>(json.size()) * num_files, seconds);
+  }
+}
+
+// Parsing a schema that includes a tree of num_files files, where the root
+// includes all others in order, and each of those includes its predecessor.
+// Every file should be read and tokenized once, so the time per file should
+// stay flat as the tree grows.
+void IncludeTreeBenchmark() {
+  const char *tmp = getenv("TMPDIR");
+  if (!tmp) tmp = getenv("TEMP");
+  #ifdef _WIN32
+    if (!tmp) tmp = ".";
+  #else
+    if (!tmp) tmp = "/tmp";
+  #endif
+  auto dir = flatbuffers::ConCatPathFileName(
+               tmp, "flatbenchmark_include_tree_" +
+                    flatbuffers::NumToString(static_cast<int>(getpid())));
+  flatbuffers::EnsureDirExists(dir);
+  auto file_path = [&](int i) {
+    return flatbuffers::ConCatPathFileName(
+             dir, "include_tree_" + flatbuffers::NumToString(i) + ".fbs");
+  };
+  for (int num_files = 125; num_files <= 1000; num_files *= 2) {
+    for (int i = 0; i < num_files; i++) {
+      std::string schema;
+      if (i == 0) {
+        for (int j = 1; j < num_files; j++)
+          schema += "include \"" + flatbuffers::StripPath(file_path(j)) +
+                    "\";\n";
+      } else if (i > 1) {
+        schema += "include \"" + flatbuffers::StripPath(file_path(i - 1)) +
+                  "\";\n";
+      }
+      schema += "table T" + flatbuffers::NumToString(i) + " { a:int; }\n";
+      flatbuffers::SaveFile(file_path(i).c_str(), schema, false);
+    }
+    std::string root;
+    flatbuffers::LoadFile(file_path(0).c_str(), false, &root);
+    const char *include_directories[] = { dir.c_str(), nullptr };
+    bool ok = true;
+    auto seconds = Time([&]() {
+      flatbuffers::Parser parser;
+      ok = parser.Parse(root.c_str(), include_directories,
+                        file_path(0).c_str());
+    });
+    if (!ok) printf("include tree: parse failed\n");
+    printf("include tree %4d files: %8.2f ms, %6.1f us/file\n", num_files,
+           seconds * 1e3, seconds * 1e6 / num_files);
+    for (int i = 0; i < num_files; i++) remove(file_path(i).c_str());
+  }
+  #ifdef _WIN32
+    _rmdir(dir.c_str());
+  #else
+    rmdir(dir.c_str());
+  #endif
+}
+
+// Parsing one large JSON file, best of 5 runs, on a single thread.
+void ParseCorpus(const char *name, flatbuffers::Parser &parser,
+                 const std::string &json) {
+  double seconds = 1e9;
+  for (int run = 0; run < 5; run++) {
+    bool ok = true;
+    seconds = std::min(seconds, Time([&]() {
+      ok = parser.Parse(json.c_str());
+    }));
+    if (!ok) printf("%s: %s\n", name, parser.error_.c_str());
+  }
+  printf("%-24s %8.1f MB/s\n", name,
+         static_cast<double>(json.size()) / seconds / (1024 * 1024));
+}
+
+// A corpus made of mostly identifiers: unquoted field names, enum values by
+// name and booleans, which the lexer has to tell apart from keywords.
+void LexIdentifiersBenchmark() {
+  flatbuffers::Parser parser;
+  if (!LoadSchema(parser)) {
+    printf("lex identifiers: unable to load tests/monster_test.fbs\n");
+    return;
+  }
+  const char *colors[] = { "Red", "Green", "Blue" };
+  std::string json = "{ name: \"root\", testarrayoftables: [\n";
+  for (int i = 0; i < 100000; i++) {
+    json += "  { name: \"m\", hp: 1, mana: 2, color: ";
+    json += colors[i % 3];
+    json += ", testbool: ";
+    json += i % 2 ? "true" : "false";
+    json += ", testhashs32_fnv1: 3, testhashu32_fnv1a: 4 },\n";
+  }
+  json += "] }\n";
+  ParseCorpus("lex identifiers", parser, json);
+}
+
+// A corpus made of mostly string constants, a few with escapes.
+void LexStringsBenchmark() {
+  flatbuffers::Parser parser;
+  if (!LoadSchema(parser)) {
+    printf("lex strings: unable to load tests/monster_test.fbs\n");
+    return;
+  }
+  std::string json = "{ name: \"root\", testarrayofstring: [\n";
+  for (int i = 0; i < 200000; i++) {
+    json += i % 10
+      ? "  \"a string constant without any escapes, of some length\",\n"
+      : "  \"a string with \\\"escapes\\\" in it,\\n and a line break\",\n";
+  }
+  json += "] }\n";
+  ParseCorpus("lex strings", parser, json);
+}
+
+// Loading a schema at startup: parsing its text, against loading the binary
+// schema (.bfbs) made from it with Deserialize(). Done for
+// tests/monster_test.fbs (with its include), and for a generated schema of
+// 1000 tables and 100 enums.
+void BinarySchemaBenchmark() {
+  std::string monster_schema;
+  if (!flatbuffers::LoadFile("tests/monster_test.fbs", false,
+                             &monster_schema)) {
+    printf("binary schema: unable to load tests/monster_test.fbs\n");
+    return;
+  }
+  std::string large_schema = "namespace Bench;\n";
+  for (int i = 0; i < 100; i++) {
+    large_schema += "enum E" + flatbuffers::NumToString(i) +
+                    " : byte { A, B, C, D }\n";
+  }
+  for (int i = 0; i < 1000; i++) {
+    large_schema += "table T" + flatbuffers::NumToString(i) + " {\n";
+    large_schema += "  name:string;\n  id:long (key);\n  ratio:double;\n";
+    large_schema += "  kind:E" + flatbuffers::NumToString(i % 100) + ";\n";
+    large_schema += "  values:[int];\n  tags:[string];\n";
+    if (i) large_schema += "  prev:T" + flatbuffers::NumToString(i - 1) + ";\n";
+    large_schema += "}\n";
+  }
+  large_schema += "root_type T999;\n";
+  const char *include_directories[] = { "tests", nullptr };
+  const char *names[] = { "monster_test.fbs", "1000 tables" };
+  const std::string *schemas[] = { &monster_schema, &large_schema };
+  for (int i = 0; i < 2; i++) {
+    flatbuffers::FlatBufferBuilder bfbs;
+    {
+      flatbuffers::Parser parser;
+      if (!parser.Parse(schemas[i]->c_str(), include_directories)) {
+        printf("binary schema: %s\n", parser.error_.c_str());
+        return;
+      }
+      parser.Serialize(bfbs);
+    }
+    double text = 1e9, binary = 1e9;
+    for (int run = 0; run < 5; run++) {
+      text = std::min(text, Time([&]() {
+        flatbuffers::Parser parser;
+        parser.Parse(schemas[i]->c_str(), include_directories);
+      }));
+      binary = std::min(binary, Time([&]() {
+        flatbuffers::Parser parser;
+        parser.Deserialize(bfbs.GetBufferPointer(), bfbs.GetSize());
+      }));
+    }
+    printf("load %-16s .fbs %8.3f ms, .bfbs %8.3f ms (%u bytes)\n",
+           names[i], text * 1e3, binary * 1e3, bfbs.GetSize());
+  }
+}
+
+// Converting one buffer with a large vector of tables to JSON, printing the
+// vector on several threads (GeneratorOptions::num_threads).
+void GenerateTextBenchmark(int max_threads) {
+  using namespace MyGame::Example;
+  flatbuffers::Parser parser;
+  if (!LoadSchema(parser)) {
+    printf("generate text: unable to load tests/monster_test.fbs\n");
+    return;
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> children;
+  for (int i = 0; i < 200000; i++) {
+    auto name = builder.CreateString("monster" + flatbuffers::NumToString(i));
+    uint8_t inventory[] = { 1, 2, 3, static_cast<uint8_t>(i) };
+    auto vec = builder.CreateVector(inventory, 4);
+    children.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i), name, vec));
+  }
+  auto vec = builder.CreateVector(children);
+  auto name = builder.CreateString("root");
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 100,
+                                             name, 0, Color_Blue, Any_NONE,
+                                             0, 0, 0, vec));
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    flatbuffers::GeneratorOptions opts;
+    opts.num_threads = threads;
+    std::string text;
+    auto seconds = Time([&]() {
+      GenerateText(parser, builder.GetBufferPointer(), opts, &text);
+    });
+    Report("generate text", threads, static_cast<double>(text.size()),
+           seconds);
+  }
+}
+
+// Writing numbers as text, as the JSON generator does, with NumToChars and
+// with the stream based NumToString it replaced. Floats and doubles are not
+// printed the same: NumToChars writes all digits needed to read the value
+// back, NumToString only 6 significant digits.
+template<typename T> void NumberFormatBenchmark(const char *name,
+                                                const std::vector<T> &vals) {
+  std::string text;
+  auto chars = Time([&]() {
+    char buf[flatbuffers::kMaxNumChars];
+    for (auto it = vals.begin(); it != vals.end(); ++it)
+      text.append(buf, flatbuffers::NumToChars(*it, buf));
+  });
+  auto chars_size = static_cast<double>(text.size());
+  text.clear();
+  auto stream = Time([&]() {
+    for (auto it = vals.begin(); it != vals.end(); ++it)
+      text += flatbuffers::NumToString(*it);
+  });
+  printf("format %-10s NumToChars %8.1f MB/s, NumToString %8.1f MB/s\n", name,
+         chars_size / chars / (1024 * 1024),
+         static_cast<double>(text.size()) / stream / (1024 * 1024));
+}
+
+void NumberFormatBenchmarks() {
+  const int num_values = 1000000;
+  std::mt19937 rng(42);
+  std::vector<int32_t> ints;
+  std::vector<int64_t> longs;
+  std::vector<float> floats;
+  std::vector<double> doubles;
+  std::uniform_real_distribution<double> real(-1e6, 1e6);
+  for (int i = 0; i < num_values; i++) {
+    ints.push_back(static_cast<int32_t>(rng()));
+    longs.push_back(static_cast<int64_t>(rng()) << 32 | rng());
+    floats.push_back(static_cast<float>(real(rng)));
+    doubles.push_back(real(rng));
+  }
+  NumberFormatBenchmark("int", ints);
+  NumberFormatBenchmark("long", longs);
+  NumberFormatBenchmark("float", floats);
+  NumberFormatBenchmark("double", doubles);
+}
+
+// Verifying a vector of small tables with the generated Verify() methods,
+// which check each inline field on its own, and in bulk against the vtable,
+// like flatc --bulk-verify generates them. Bulk verification only checks the
+// fields of a vtable once, so it is faster when tables share their vtable,
+// and slower when consecutive tables have different ones.
+void VerifyBenchmark() {
+  using namespace MyGame::Example;
+  const int num_tables = 1000000;
+  const int num_runs = 20;
+  static const flatbuffers::voffset_t stat_field_sizes[] = {
+    sizeof(flatbuffers::uoffset_t), sizeof(int64_t), sizeof(uint16_t)
+  };
+  auto bulk_verify = [](flatbuffers::Verifier &verifier, const Stat *stat) {
+    return reinterpret_cast<const flatbuffers::Table *>(stat)->
+             VerifyTableFields(verifier, stat_field_sizes) &&
+           verifier.Verify(stat->id()) && verifier.EndTable();
+  };
+  // Tables with all fields present share one vtable, otherwise every table
+  // has a different vtable from the one before it.
+  for (int shared = 1; shared >= 0; shared--) {
+    flatbuffers::FlatBufferBuilder builder;
+    auto id = builder.CreateString("stat");
+    std::vector<flatbuffers::Offset<Stat>> stats;
+    for (int i = 0; i < num_tables; i++) {
+      stats.push_back(CreateStat(builder, id, shared || i % 2 ? i + 1 : 0,
+                                 shared || i % 3 ? 1 : 0));
+    }
+    builder.Finish(builder.CreateVector(stats));
+    auto buf = builder.GetBufferPointer();
+    auto vec = flatbuffers::GetRoot<
+                 flatbuffers::Vector<flatbuffers::Offset<Stat>>>(buf);
+    double per_field = 1e9, bulk = 1e9;
+    for (int run = 0; run < num_runs; run++) {
+      per_field = std::min(per_field, Time([&]() {
+        flatbuffers::Verifier verifier(buf, builder.GetSize());
+        if (!verifier.VerifyVectorOfTables(vec)) printf("verify failed\n");
+      }));
+      bulk = std::min(bulk, Time([&]() {
+        flatbuffers::Verifier verifier(buf, builder.GetSize());
+        for (flatbuffers::uoffset_t i = 0; i < vec->size(); i++) {
+          if (!bulk_verify(verifier, vec->Get(i))) printf("verify failed\n");
+        }
+      }));
+    }
+    printf("verify, %s vtables: per field %.1f ns/table, bulk %.1f ns/table\n",
+           shared ? "shared" : "alternating", per_field * 1e9 / num_tables,
+           bulk * 1e9 / num_tables);
+  }
+}
+
+int main(int argc, const char *argv[]) {
+  int max_threads = argc > 1
+    ? atoi(argv[1])
+    : static_cast<int>(std::thread::hardware_concurrency());
+  if (max_threads < 1) max_threads = 1;
+
+  SmallBuildersBenchmark();
+  VTableDedupBenchmark();
+  SharedStringsBenchmark();
+  ScalarVectorBenchmark();
+  ParseJsonBenchmark(max_threads);
+  IncludeTreeBenchmark();
+  LexIdentifiersBenchmark();
+  LexStringsBenchmark();
+  BinarySchemaBenchmark();
+  GenerateTextBenchmark(max_threads);
+  NumberFormatBenchmarks();
+  VerifyBenchmark();
+  return 0;
+}
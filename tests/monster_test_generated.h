@@ -46,6 +46,8 @@ inline const char *EnumNameAny(Any e) { return EnumNamesAny()[e]; }
 
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, Any type);
 
+inline size_t MaxSerializedSizeAny(const void *union_obj, Any type);
+
 MANUALLY_ALIGNED_STRUCT(2) Test FLATBUFFERS_FINAL_CLASS {
  private:
   int16_t a_;
@@ -98,6 +100,12 @@ struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyField<uint16_t>(verifier, 8 /* count */) &&
            verifier.EndTable();
   }
+  static size_t MaxTableSize() { return 42; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (id()) size += flatbuffers::MaxStringSize(id()->size());
+    return size;
+  }
 };
 
 struct StatBuilder {
@@ -125,6 +133,12 @@ inline flatbuffers::Offset<Stat> CreateStat(flatbuffers::FlatBufferBuilder &_fbb
   return builder_.Finish();
 }
 
+inline size_t MaxStatSize(
+   size_t id_length = 0) {
+  return Stat::MaxTableSize() +
+         flatbuffers::MaxStringSize(id_length);
+}
+
 struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const Vec3 *pos() const { return GetStruct<const Vec3 *>(4); }
   int16_t mana() const { return GetField<int16_t>(6, 150); }
@@ -192,6 +206,28 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyField<uint64_t>(verifier, 50 /* testhashu64_fnv1a */) &&
            verifier.EndTable();
   }
+  static size_t MaxTableSize() { return 266; }
+  size_t MaxSerializedSize() const {
+    size_t size = MaxTableSize();
+    if (name()) size += flatbuffers::MaxStringSize(name()->size());
+    if (inventory()) size += flatbuffers::MaxVectorSize(inventory()->size(), 1, 1);
+    if (test()) size += MaxSerializedSizeAny(test(), test_type());
+    if (test4()) size += flatbuffers::MaxVectorSize(test4()->size(), 4, 2);
+    if (testarrayofstring()) {
+      size += flatbuffers::MaxVectorSize(testarrayofstring()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < testarrayofstring()->size(); i++)
+        size += flatbuffers::MaxStringSize(testarrayofstring()->Get(i)->size());
+    }
+    if (testarrayoftables()) {
+      size += flatbuffers::MaxVectorSize(testarrayoftables()->size(), 4, 4);
+      for (flatbuffers::uoffset_t i = 0; i < testarrayoftables()->size(); i++)
+        size += testarrayoftables()->Get(i)->MaxSerializedSize();
+    }
+    if (enemy()) size += enemy()->MaxSerializedSize();
+    if (testnestedflatbuffer()) size += flatbuffers::MaxVectorSize(testnestedflatbuffer()->size(), 1, 1);
+    if (testempty()) size += testempty()->MaxSerializedSize();
+    return size;
+  }
 };
 
 struct MonsterBuilder {
@@ -280,6 +316,33 @@ inline flatbuffers::Offset<Monster> CreateMonster(flatbuffers::FlatBufferBuilder
   return builder_.Finish();
 }
 
+inline size_t MaxMonsterSize(
+   size_t name_length = 0,
+   size_t inventory_length = 0,
+   size_t test_size = 0,
+   size_t test4_length = 0,
+   size_t testarrayofstring_length = 0,
+   size_t testarrayofstring_bytes = 0,
+   size_t testarrayoftables_length = 0,
+   size_t testarrayoftables_size = 0,
+   size_t enemy_size = 0,
+   size_t testnestedflatbuffer_length = 0,
+   size_t testempty_size = 0) {
+  return Monster::MaxTableSize() +
+         flatbuffers::MaxStringSize(name_length) +
+         flatbuffers::MaxVectorSize(inventory_length, 1, 1) +
+         test_size +
+         flatbuffers::MaxVectorSize(test4_length, 4, 2) +
+         flatbuffers::MaxVectorSize(testarrayofstring_length, 4, 4) +
+         testarrayofstring_length * flatbuffers::MaxStringSize(0) +
+         testarrayofstring_bytes +
+         flatbuffers::MaxVectorSize(testarrayoftables_length, 4, 4) +
+         testarrayoftables_size +
+         enemy_size +
+         flatbuffers::MaxVectorSize(testnestedflatbuffer_length, 1, 1) +
+         testempty_size;
+}
+
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, Any type) {
   switch (type) {
     case Any_NONE: return true;
@@ -288,10 +351,19 @@ inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, An
   }
 }
 
+inline size_t MaxSerializedSizeAny(const void *union_obj, Any type) {
+  switch (type) {
+    case Any_Monster: return reinterpret_cast<const Monster *>(union_obj)->MaxSerializedSize();
+    default: return 0;
+  }
+}
+
 inline const Monster *GetMonster(const void *buf) { return flatbuffers::GetRoot<Monster>(buf); }
 
 inline bool VerifyMonsterBuffer(flatbuffers::Verifier &verifier) { return verifier.VerifyBuffer<Monster>(); }
 
+inline size_t MonsterBufferMaxSize(const Monster *root) { return root->MaxSerializedSize() + flatbuffers::MaxFinishSize(16); }
+
 inline const char *MonsterIdentifier() { return "MONS"; }
 
 inline bool MonsterBufferHasIdentifier(const void *buf) { return flatbuffers::BufferHasIdentifier(buf, MonsterIdentifier()); }
@@ -16,11 +16,24 @@
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/reflection_generated.h"
 #include "flatbuffers/util.h"
 
-#include "monster_test_generated.h"
+// Built a second time against code generated with --bulk-verify, to also
+// run these tests on its Verify() methods.
+#ifdef FLATBUFFERS_TEST_BULK_VERIFY
+  #include "bulk_verify/monster_test_generated.h"
+#else
+  #include "monster_test_generated.h"
+#endif
 
 #include <random>
+#include <thread>
+
+#ifdef _WIN32
+  #include <process.h>
+  #define getpid _getpid
+#endif
 
 using namespace MyGame::Example;
 
@@ -237,6 +250,62 @@ void ParseAndGenerateTextTest() {
     printf("%s----------------\n%s", jsongen.c_str(), jsonfile.c_str());
     TEST_NOTNULL(NULL);
   }
+
+  // Streaming through a small buffer must give the same text, in pieces.
+  std::string streamed;
+  int writes = 0;
+  flatbuffers::CallbackTextSink sink([&](const char *data, size_t size) {
+    streamed.append(data, size);
+    writes++;
+    return true;
+  }, 16);
+  GenerateText(parser, parser.builder_.GetBufferPointer(), opts, &sink);
+  TEST_EQ(sink.Flush(), true);
+  TEST_EQ(streamed == jsonfile, true);
+  TEST_EQ(writes > 10, true);
+}
+
+// Printing a large vector of tables on several threads must give the same
+// text as printing it on one.
+void ParallelTextTest() {
+  std::string schemafile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+
+  auto &builder = parser.builder_;
+  std::vector<flatbuffers::Offset<Monster>> children;
+  for (int i = 0; i < 5000; i++) {
+    auto name = builder.CreateString("monster" + flatbuffers::NumToString(i));
+    uint8_t inventory[] = { 1, static_cast<uint8_t>(i) };
+    auto vec = builder.CreateVector(inventory, 2);
+    MonsterBuilder child(builder);
+    child.add_name(name);
+    child.add_hp(static_cast<int16_t>(i));
+    child.add_inventory(vec);
+    children.push_back(child.Finish());
+  }
+  auto vec = builder.CreateVector(children);
+  auto name = builder.CreateString("root");
+  MonsterBuilder root(builder);
+  root.add_name(name);
+  root.add_testarrayoftables(vec);
+  FinishMonsterBuffer(builder, root.Finish());
+
+  for (int indent_step = -1; indent_step <= 2; indent_step += 3) {
+    flatbuffers::GeneratorOptions opts;
+    opts.indent_step = indent_step;
+    std::string sequential;
+    GenerateText(parser, builder.GetBufferPointer(), opts, &sequential);
+    for (int num_threads = 2; num_threads <= 3; num_threads++) {
+      opts.num_threads = num_threads;
+      std::string parallel;
+      GenerateText(parser, builder.GetBufferPointer(), opts, &parallel);
+      TEST_EQ(parallel == sequential, true);
+    }
+  }
 }
 
 // Parse a .proto schema, output as .fbs
@@ -356,6 +425,660 @@ void FuzzTest1() {
   }
 }
 
+// Build a large number of tables with distinct layouts, twice, and make sure
+// the second time around all vtables are shared with the first.
+void VTableDedupTest() {
+  const flatbuffers::voffset_t max_fields = 200;  // ~20k distinct vtables.
+
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::uoffset_t> objects;
+  flatbuffers::uoffset_t first_pass_size = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    for (flatbuffers::voffset_t b = 1; b < max_fields; b++) {
+      for (flatbuffers::voffset_t a = 0; a < b; a++) {
+        auto start = builder.StartTable();
+        builder.AddElement<uint32_t>(flatbuffers::FieldIndexToOffset(a),
+                                     a + 1, 0);
+        builder.AddElement<uint32_t>(flatbuffers::FieldIndexToOffset(b),
+                                     b + 1, 0);
+        // An even number of fields keeps the vtables 4 byte aligned, so no
+        // table needs padding, and each layout only has one possible vtable.
+        objects.push_back(builder.EndTable(start, (b + 2) & ~1));
+      }
+    }
+    if (!pass) {
+      builder.Align(sizeof(uint32_t));
+      first_pass_size = builder.GetSize();
+    }
+  }
+  // Second pass only wrote tables: vtable offset + 2 fields each.
+  auto num_tables = static_cast<flatbuffers::uoffset_t>(objects.size() / 2);
+  TEST_EQ(builder.GetSize() - first_pass_size, num_tables * 12);
+
+  auto eob = builder.GetBufferPointer() + builder.GetSize();
+  size_t i = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    for (flatbuffers::voffset_t b = 1; b < max_fields; b++) {
+      for (flatbuffers::voffset_t a = 0; a < b; a++) {
+        auto table = reinterpret_cast<flatbuffers::Table *>(eob - objects[i]);
+        auto twin = reinterpret_cast<flatbuffers::Table *>(
+                      eob - objects[i % num_tables]);
+        TEST_EQ(table->GetField<uint32_t>(
+                  flatbuffers::FieldIndexToOffset(a), 0), a + 1U);
+        TEST_EQ(table->GetField<uint32_t>(
+                  flatbuffers::FieldIndexToOffset(b), 0), b + 1U);
+        TEST_EQ(flatbuffers::ReadScalar<flatbuffers::soffset_t>(table) -
+                flatbuffers::ReadScalar<flatbuffers::soffset_t>(twin),
+                reinterpret_cast<uint8_t *>(table) -
+                reinterpret_cast<uint8_t *>(twin));
+        i++;
+      }
+    }
+  }
+}
+
+// Inline fields are verified in bulk against the table size in the vtable,
+// so a field that runs past the end of its table must be rejected even when
+// it is still inside the buffer.
+void VerifyTableFieldsTest() {
+  std::string rawbuf;
+  CreateFlatBufferTest(rawbuf);
+  auto buf = reinterpret_cast<uint8_t *>(&rawbuf[0]);
+  auto table = buf + flatbuffers::ReadScalar<flatbuffers::uoffset_t>(buf);
+  auto vtable = table - flatbuffers::ReadScalar<flatbuffers::soffset_t>(table);
+  auto objsize = flatbuffers::ReadScalar<flatbuffers::voffset_t>(
+                   vtable + sizeof(flatbuffers::voffset_t));
+  auto hp_slot = vtable + 8;  // hp: int16_t.
+  auto hp = flatbuffers::ReadScalar<flatbuffers::voffset_t>(hp_slot);
+  // The inline sizes of pos, mana and hp, as flatc --bulk-verify generates
+  // them.
+  static const flatbuffers::voffset_t field_sizes[] = {
+    sizeof(Vec3), sizeof(int16_t), sizeof(int16_t)
+  };
+  auto verify = [&]() {
+    flatbuffers::Verifier verifier(buf, rawbuf.length());
+    return reinterpret_cast<const flatbuffers::Table *>(table)->
+             VerifyTableFields(verifier, field_sizes);
+  };
+  TEST_EQ(verify(), true);
+
+  // Last 2 bytes of the table: still fine.
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(hp_slot, objsize - 2);
+  TEST_EQ(verify(), true);
+  // One byte past the end of the table.
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(hp_slot, objsize - 1);
+  TEST_EQ(verify(), false);
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(hp_slot, hp);
+
+  // A table size larger than the buffer.
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(
+    vtable + sizeof(flatbuffers::voffset_t),
+    static_cast<flatbuffers::voffset_t>(buf + rawbuf.length() - table + 1));
+  TEST_EQ(verify(), false);
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(
+    vtable + sizeof(flatbuffers::voffset_t), objsize);
+
+  // A vtable too short to hold the table size.
+  auto vtsize = flatbuffers::ReadScalar<flatbuffers::voffset_t>(vtable);
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(vtable, 2);
+  TEST_EQ(verify(), false);
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(vtable, vtsize);
+  TEST_EQ(verify(), true);
+
+  // The generated Verify(), which in the flattests_bulk_verify build comes
+  // from flatc --bulk-verify, must catch an inline field running past the
+  // end of the buffer too.
+  auto verify_monster = [&]() {
+    flatbuffers::Verifier verifier(buf, rawbuf.length());
+    return VerifyMonsterBuffer(verifier);
+  };
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(
+    hp_slot,
+    static_cast<flatbuffers::voffset_t>(buf + rawbuf.length() - table - 1));
+  TEST_EQ(verify_monster(), false);
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(hp_slot, hp);
+  TEST_EQ(verify_monster(), true);
+}
+
+// A large vector of tables verified on several threads must give the same
+// verdict as a single thread, including for the max_tables limit.
+void ParallelVerifyTest() {
+  const int num_children = 1000;
+  flatbuffers::FlatBufferBuilder builder;
+  auto name = builder.CreateString("child");
+  std::vector<flatbuffers::Offset<Monster>> children;
+  for (int i = 0; i < num_children; i++) {
+    MonsterBuilder child(builder);
+    child.add_name(name);
+    child.add_hp(static_cast<int16_t>(i));
+    if (i == num_children - 2) child.add_mana(1);  // Gets its own vtable.
+    children.push_back(child.Finish());
+  }
+  auto vec = builder.CreateVector(children);
+  auto root_name = builder.CreateString("root");
+  MonsterBuilder root(builder);
+  root.add_name(root_name);
+  root.add_testarrayoftables(vec);
+  FinishMonsterBuffer(builder, root.Finish());
+  auto buf = builder.GetBufferPointer();
+
+  auto verify = [&](size_t num_threads, size_t max_tables) {
+    flatbuffers::Verifier verifier(buf, builder.GetSize(), 64, max_tables);
+    verifier.SetExecutor(flatbuffers::RunOnThreads, num_threads, 100);
+    return VerifyMonsterBuffer(verifier);
+  };
+  const size_t num_tables = num_children + 1;
+  for (size_t num_threads = 1; num_threads <= 4; num_threads++) {
+    TEST_EQ(verify(num_threads, num_tables), true);
+    TEST_EQ(verify(num_threads, num_tables - 1), false);
+  }
+
+  // Break a table near the end of the vector, so only the last thread sees
+  // it: its name now points past the end of the buffer.
+  auto child = GetMonster(buf)->testarrayoftables()->Get(num_children - 2);
+  auto table = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(child));
+  auto vtable = table - flatbuffers::ReadScalar<flatbuffers::soffset_t>(table);
+  auto name_field = table + flatbuffers::ReadScalar<flatbuffers::voffset_t>(
+                              vtable + 10 /* name */);
+  flatbuffers::WriteScalar<flatbuffers::uoffset_t>(
+    name_field, static_cast<flatbuffers::uoffset_t>(builder.GetSize()));
+  for (size_t num_threads = 1; num_threads <= 4; num_threads++) {
+    TEST_EQ(verify(num_threads, num_tables), false);
+  }
+}
+
+// Each level of monsters holds the previous level twice, so there are 2^20
+// paths to the bottom of a buffer of only 21 tables.
+void MemoizeTablesTest() {
+  const int depth = 20;
+  flatbuffers::FlatBufferBuilder builder;
+  auto name = builder.CreateString("dag");
+  flatbuffers::Offset<Monster> level;
+  for (int i = 0; i <= depth; i++) {
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Monster>>> vec;
+    if (i) {
+      flatbuffers::Offset<Monster> children[] = { level, level };
+      vec = builder.CreateVector(children, 2);
+    }
+    MonsterBuilder monster(builder);
+    monster.add_name(name);
+    monster.add_testarrayoftables(vec);
+    level = monster.Finish();
+  }
+  FinishMonsterBuffer(builder, level);
+
+  flatbuffers::Verifier memoized(builder.GetBufferPointer(), builder.GetSize(),
+                                 64, depth + 1);
+  memoized.SetMemoizeTables(true);
+  TEST_EQ(VerifyMonsterBuffer(memoized), true);
+  flatbuffers::Verifier exhaustive(builder.GetBufferPointer(),
+                                   builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(exhaustive), false);  // Over max_tables.
+
+  // A table reached as two different types must be verified as both: here a
+  // monster is also used as a Stat, whose string field would be its pos.
+  flatbuffers::FlatBufferBuilder confused;
+  name = confused.CreateString("confused");
+  auto pos = Vec3(1, 2, 3, 0, Color_Red, Test(10, 20));
+  auto child = CreateMonster(confused, &pos, 150, 100, name);
+  auto vec = confused.CreateVector(&child, 1);
+  MonsterBuilder root(confused);
+  root.add_name(name);
+  root.add_testarrayoftables(vec);
+  root.add_testempty(flatbuffers::Offset<Stat>(child.o));
+  FinishMonsterBuffer(confused, root.Finish());
+  flatbuffers::Verifier verifier(confused.GetBufferPointer(),
+                                 confused.GetSize());
+  verifier.SetMemoizeTables(true);
+  TEST_EQ(VerifyMonsterBuffer(verifier), false);
+}
+
+// Repeated strings should only be stored once when shared, whether asked for
+// explicitly or for all strings.
+void SharedStringTest() {
+  const char *tags[] = { "alpha", "beta", "", "alpha\0beta", "gamma" };
+  const size_t tag_lens[] = { 5, 4, 0, 10, 5 };
+  const int num_tags = sizeof(tags) / sizeof(tags[0]);
+  const int num_strings = 1000;
+
+  flatbuffers::FlatBufferBuilder copied, shared, interned;
+  interned.InternStrings(true);
+  std::vector<flatbuffers::Offset<flatbuffers::String>> shared_offs;
+  for (int i = 0; i < num_strings; i++) {
+    auto tag = i % num_tags;
+    copied.CreateString(tags[tag], tag_lens[tag]);
+    shared_offs.push_back(shared.CreateSharedString(tags[tag], tag_lens[tag]));
+    interned.CreateString(tags[tag], tag_lens[tag]);
+    if (i >= num_tags) TEST_EQ(shared_offs[i].o, shared_offs[tag].o);
+  }
+  TEST_EQ(shared.GetSize(), interned.GetSize());
+  TEST_EQ(shared.GetSize() * (num_strings / num_tags), copied.GetSize());
+
+  // Strings created without sharing are never returned for shared ones.
+  auto unshared = shared.CreateString("alpha");
+  TEST_EQ(shared.CreateSharedString("alpha").o, shared_offs[0].o);
+  TEST_EQ(unshared.o != shared_offs[0].o, true);
+
+  auto vec = shared.CreateVector(shared_offs);
+  shared.Finish(vec);
+  auto strings = flatbuffers::GetRoot<flatbuffers::Vector<
+                   flatbuffers::Offset<flatbuffers::String>>>(
+                     shared.GetBufferPointer());
+  for (int i = 0; i < num_strings; i++) {
+    auto tag = i % num_tags;
+    TEST_EQ(strings->Get(i)->size(), tag_lens[tag]);
+    TEST_EQ(memcmp(strings->Get(i)->c_str(), tags[tag], tag_lens[tag]), 0);
+  }
+
+  // Nothing is shared across Clear().
+  shared.Clear();
+  auto fresh = shared.CreateSharedString("alpha");
+  TEST_EQ(fresh.o, shared.GetSize());
+}
+
+// Builders using a pool_allocator should reuse the same memory build after
+// build, including after releasing their buffer.
+void PoolAllocatorTest() {
+  flatbuffers::pool_allocator pool;
+  const uint8_t *first_end = nullptr;
+  for (int i = 0; i < 3; i++) {
+    flatbuffers::FlatBufferBuilder builder(1024, &pool);
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    for (int j = 0; j < 50; j++) {
+      strings.push_back(builder.CreateString(flatbuffers::NumToString(j)));
+    }
+    builder.Finish(builder.CreateVector(strings));
+    auto size = builder.GetSize();
+    auto end = builder.GetBufferPointer() + size;
+    if (!i) first_end = end;
+    TEST_EQ(end == first_end, true);
+    // Freeing this returns the block to the pool, not the heap.
+    auto buf = builder.ReleaseBufferPointer();
+    auto vec = flatbuffers::GetRoot<flatbuffers::Vector<
+                 flatbuffers::Offset<flatbuffers::String>>>(buf.get());
+    TEST_EQ(vec->size(), 50U);
+    TEST_EQ(strcmp(vec->Get(49)->c_str(), "49"), 0);
+  }
+  // Growing also recycles blocks of the sizes in between.
+  for (int i = 0; i < 3; i++) {
+    flatbuffers::FlatBufferBuilder builder(64, &pool);
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    for (int j = 0; j < 1000; j++) {
+      strings.push_back(builder.CreateString(flatbuffers::NumToString(j)));
+    }
+    builder.Finish(builder.CreateVector(strings));
+    auto vec = flatbuffers::GetRoot<flatbuffers::Vector<
+                 flatbuffers::Offset<flatbuffers::String>>>(
+                   builder.GetBufferPointer());
+    TEST_EQ(vec->size(), 1000U);
+    TEST_EQ(strcmp(vec->Get(999)->c_str(), "999"), 0);
+  }
+  flatbuffers::pool_allocator::trim();
+}
+
+// Build the same buffer contiguously and in small chunks, the bytes should
+// come out the same either way.
+void ChunkedStorageTest() {
+  auto build = [](flatbuffers::FlatBufferBuilder &builder) {
+    std::vector<flatbuffers::Offset<Monster>> monsters;
+    for (int i = 0; i < 200; i++) {
+      auto name = builder.CreateSharedString("monster" +
+                                             flatbuffers::NumToString(i % 50));
+      std::vector<uint8_t> inventory(i % 100, static_cast<uint8_t>(i));
+      Test tests[] = { Test(static_cast<int16_t>(i), 1), Test(2, 3) };
+      auto vec = Vec3(1, 2, static_cast<float>(i), 0, Color_Red, Test(10, 20));
+      monsters.push_back(CreateMonster(builder, &vec, 150,
+                                       static_cast<int16_t>(i), name,
+                                       builder.CreateVector(inventory),
+                                       Color_Green, Any_NONE, 0,
+                                       builder.CreateVectorOfStructs(tests, 2)));
+    }
+    auto name = builder.CreateString("root");
+    FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 100,
+                                               name, 0, Color_Blue, Any_NONE,
+                                               0, 0, 0,
+                                               builder.CreateVector(monsters)));
+  };
+
+  flatbuffers::FlatBufferBuilder contiguous;
+  build(contiguous);
+
+  flatbuffers::FlatBufferBuilder chunked(64);
+  chunked.ChunkedStorage(256);
+  build(chunked);
+  TEST_EQ(chunked.GetSize(), contiguous.GetSize());
+
+  auto slices = chunked.GetBufferSlices();
+  TEST_EQ(slices.size() > 1, true);
+  size_t total = 0;
+  for (auto it = slices.begin(); it != slices.end(); ++it) total += it->size;
+  TEST_EQ(total, static_cast<size_t>(chunked.GetSize()));
+
+  std::vector<uint8_t> flat(chunked.GetSize());
+  chunked.CopyBuffer(flat.data());
+  TEST_EQ(memcmp(flat.data(), contiguous.GetBufferPointer(), flat.size()), 0);
+
+  flatbuffers::Verifier verifier(flat.data(), flat.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto monsters = GetMonster(flat.data())->testarrayoftables();
+  TEST_EQ(monsters->Length(), 200U);
+  TEST_EQ(monsters->Get(199)->inventory()->Length(), 99U);
+  TEST_EQ(strcmp(monsters->Get(199)->name()->c_str(), "monster49"), 0);
+
+  // After Clear(), it's back to a single (empty) chunk.
+  chunked.Clear();
+  TEST_EQ(chunked.GetBufferSlices().size(), 1U);
+  TEST_EQ(chunked.GetSize(), 0U);
+}
+
+// Counts allocations, to see how often a builder grows its buffer.
+class CountingAllocator : public flatbuffers::simple_allocator {
+ public:
+  CountingAllocator() : allocations(0) {}
+  uint8_t *allocate(size_t size) const {
+    allocations++;
+    return simple_allocator::allocate(size);
+  }
+  mutable int allocations;
+};
+
+// Reserving the generated upper bound on a buffer's size up front should
+// make building it allocate only once.
+void ReserveTest() {
+  auto build = [](flatbuffers::FlatBufferBuilder &builder) {
+    std::vector<flatbuffers::Offset<Monster>> monsters;
+    for (int i = 0; i < 200; i++) {
+      auto name = builder.CreateString("monster" + flatbuffers::NumToString(i));
+      std::vector<uint8_t> inventory(i % 100, static_cast<uint8_t>(i));
+      Test tests[] = { Test(static_cast<int16_t>(i), 1), Test(2, 3) };
+      auto vec = Vec3(1, 2, static_cast<float>(i), 0, Color_Red, Test(10, 20));
+      monsters.push_back(CreateMonster(builder, &vec, 150,
+                                       static_cast<int16_t>(i), name,
+                                       builder.CreateVector(inventory),
+                                       Color_Green, Any_NONE, 0,
+                                       builder.CreateVectorOfStructs(tests, 2)));
+    }
+    auto name = builder.CreateString("root");
+    FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 100,
+                                               name, 0, Color_Blue, Any_NONE,
+                                               0, 0, 0,
+                                               builder.CreateVector(monsters)));
+  };
+
+  CountingAllocator growing_allocator;
+  flatbuffers::FlatBufferBuilder growing(64, &growing_allocator);
+  build(growing);
+  TEST_EQ(growing_allocator.allocations > 2, true);
+
+  auto max_size = MonsterBufferMaxSize(GetMonster(growing.GetBufferPointer()));
+  TEST_EQ(max_size >= growing.GetSize(), true);
+
+  // Once for the initial buffer, once for the reservation.
+  CountingAllocator reserved_allocator;
+  flatbuffers::FlatBufferBuilder reserved(64, &reserved_allocator);
+  reserved.Reserve(max_size);
+  build(reserved);
+  TEST_EQ(reserved_allocator.allocations, 2);
+  TEST_EQ(reserved.GetSize(), growing.GetSize());
+  TEST_EQ(memcmp(reserved.GetBufferPointer(), growing.GetBufferPointer(),
+                 growing.GetSize()), 0);
+
+  // The same, bounded up front from what is passed to CreateMonster.
+  size_t children_size = 0;
+  for (int i = 0; i < 200; i++) {
+    auto name_length = ("monster" + flatbuffers::NumToString(i)).size();
+    children_size += MaxMonsterSize(name_length, i % 100, 0, 2);
+  }
+  auto args_max_size = MaxMonsterSize(4, 0, 0, 0, 0, 0, 200, children_size) +
+                       flatbuffers::MaxFinishSize();
+  TEST_EQ(args_max_size >= growing.GetSize(), true);
+  CountingAllocator args_allocator;
+  flatbuffers::FlatBufferBuilder args_reserved(64, &args_allocator);
+  args_reserved.Reserve(args_max_size);
+  build(args_reserved);
+  TEST_EQ(args_allocator.allocations, 2);
+
+  // The bound counts every field, so it holds with defaults written too.
+  flatbuffers::FlatBufferBuilder defaults;
+  defaults.ForceDefaults(true);
+  build(defaults);
+  TEST_EQ(max_size >= defaults.GetSize(), true);
+
+  // Also for a buffer with a union, and vectors of strings and tables.
+  std::string rawbuf;
+  CreateFlatBufferTest(rawbuf);
+  TEST_EQ(MonsterBufferMaxSize(GetMonster(rawbuf.data())) >= rawbuf.size(),
+          true);
+}
+
+// Scalar vectors are copied in bulk, which should give the same bytes as
+// pushing the elements one at a time.
+template<typename T> void CheckScalarVector(const std::vector<T> &v) {
+  flatbuffers::FlatBufferBuilder bulk, single;
+  bulk.PushElement<uint8_t>(1);  // Make the vector need padding.
+  single.PushElement<uint8_t>(1);
+  bulk.Finish(bulk.CreateVector(v));
+  single.StartVector(v.size(), sizeof(T));
+  for (auto i = v.size(); i > 0; ) single.PushElement(v[--i]);
+  single.Finish(flatbuffers::Offset<flatbuffers::Vector<T>>(
+                  single.EndVector(v.size())));
+  TEST_EQ(bulk.GetSize(), single.GetSize());
+  TEST_EQ(memcmp(bulk.GetBufferPointer(), single.GetBufferPointer(),
+                 bulk.GetSize()), 0);
+  auto vec = flatbuffers::GetRoot<flatbuffers::Vector<T>>(
+               bulk.GetBufferPointer());
+  TEST_EQ(vec->size(), v.size());
+  for (size_t i = 0; i < v.size(); i++) TEST_EQ(vec->Get(i), v[i]);
+}
+
+void ScalarVectorTest() {
+  std::vector<int16_t> shorts;
+  std::vector<float> floats;
+  std::vector<int64_t> longs;
+  std::vector<uint8_t> bytes;
+  for (int i = 0; i < 1000; i++) {
+    shorts.push_back(static_cast<int16_t>(i * 37));
+    floats.push_back(static_cast<float>(i) / 3);
+    longs.push_back(static_cast<int64_t>(i) << 40);
+    bytes.push_back(static_cast<uint8_t>(i));
+  }
+  CheckScalarVector(shorts);
+  CheckScalarVector(floats);
+  CheckScalarVector(longs);
+  CheckScalarVector(bytes);
+  CheckScalarVector(std::vector<double>());
+}
+
+// Write a few size prefixed buffers back to back, then walk them.
+void SizePrefixedTest() {
+  std::string stream;
+  const int num_buffers = 3;
+  for (int i = 0; i < num_buffers; i++) {
+    flatbuffers::FlatBufferBuilder builder;
+    auto name = builder.CreateString("monster" + flatbuffers::NumToString(i));
+    auto vec = Vec3(1, 2, 3, 0, Color_Red, Test(10, 20));
+    auto monster = CreateMonster(builder, i == 1 ? &vec : nullptr, 150,
+                                 static_cast<int16_t>(i), name);
+    builder.FinishSizePrefixed(monster, i ? MonsterIdentifier() : nullptr);
+    TEST_EQ(builder.GetSize() % sizeof(flatbuffers::largest_scalar_t), 0U);
+    auto buf = builder.GetBufferPointer();
+    TEST_EQ(flatbuffers::GetPrefixedSize(buf) + sizeof(flatbuffers::uoffset_t),
+            static_cast<size_t>(builder.GetSize()));
+    flatbuffers::Verifier verifier(buf, builder.GetSize());
+    TEST_EQ(verifier.VerifySizePrefixedBuffer<Monster>(), true);
+    TEST_EQ(flatbuffers::GetSizePrefixedRoot<Monster>(buf)->hp(), i);
+    stream.append(reinterpret_cast<const char *>(buf), builder.GetSize());
+  }
+
+  flatbuffers::SizePrefixedBufferIterator it(stream.data(), stream.size());
+  int n = 0;
+  while (it.Next()) {
+    flatbuffers::Verifier verifier(it.GetBuffer(), it.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto monster = GetMonster(it.GetBuffer());
+    TEST_EQ(monster->hp(), n);
+    TEST_EQ(MonsterBufferHasIdentifier(it.GetBuffer()), n != 0);
+    n++;
+  }
+  TEST_EQ(n, num_buffers);
+  TEST_EQ(it.GetOffset(), stream.size());
+
+  // A truncated buffer at the end is not returned.
+  flatbuffers::SizePrefixedBufferIterator partial(stream.data(),
+                                                  stream.size() - 1);
+  size_t last_offset = 0;
+  n = 0;
+  while (partial.Next()) {
+    last_offset = partial.GetOffset();
+    n++;
+  }
+  TEST_EQ(n, num_buffers - 1);
+  TEST_EQ(partial.GetOffset(), last_offset);
+
+  // Nor does that pass verification.
+  flatbuffers::Verifier verifier(
+    reinterpret_cast<const uint8_t *>(stream.data()) + last_offset,
+    stream.size() - 1 - last_offset);
+  TEST_EQ(verifier.VerifySizePrefixedBuffer<Monster>(), false);
+}
+
+// Streams of JSON objects should come out as streams of size prefixed
+// buffers, no matter how they are separated or split across reads.
+void JsonStreamTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { a:int; s:string; } root_type T;"), true);
+  // Strings and comments may contain braces, and a record may be larger
+  // than what is read from the stream at once.
+  std::string big(100000, 'x');
+  std::stringstream in("{ a: 0, s: \"}{\" }{a:1}// {\n"
+                       "\t{ \"a\": 2,\n \"s\": \"" + big + "\" }\n");
+  std::stringstream out;
+  TEST_EQ(parser.ParseJsonStream(in, out), true);
+  auto stream = out.str();
+  flatbuffers::SizePrefixedBufferIterator it(stream.data(), stream.size());
+  int n = 0;
+  while (it.Next()) {
+    auto root = flatbuffers::GetRoot<flatbuffers::Table>(it.GetBuffer());
+    TEST_EQ(root->GetField<int32_t>(4, 0), n);
+    auto s = root->GetPointer<const flatbuffers::String *>(6);
+    TEST_EQ(s ? s->size() : 0, n == 0 ? 2U : n == 2 ? big.size() : 0U);
+    n++;
+  }
+  TEST_EQ(n, 3);
+  TEST_EQ(it.GetOffset(), stream.size());
+
+  // Objects before an error are still written, and the error reports the
+  // line within the whole stream.
+  std::stringstream bad_in("{ a: 1 }\n{ a: 2 }\n{ a: 3,\n b: 4 }\n{ a: 5 }");
+  std::stringstream bad_out;
+  TEST_EQ(parser.ParseJsonStream(bad_in, bad_out), false);
+  TEST_EQ(parser.error_.substr(0, 2), std::string("4:"));
+  auto bad_stream = bad_out.str();
+  flatbuffers::SizePrefixedBufferIterator bad_it(bad_stream.data(),
+                                                 bad_stream.size());
+  n = 0;
+  while (bad_it.Next()) n++;
+  TEST_EQ(n, 2);
+
+  // As is an object cut short by the end of the stream.
+  std::stringstream cut_in("{ a: 1 } { a:");
+  std::stringstream cut_out;
+  TEST_EQ(parser.ParseJsonStream(cut_in, cut_out), false);
+  TEST_NOTNULL(strstr(parser.error_.c_str(), "end of file"));
+}
+
+// Mapped files should read the same as loaded ones, and always be followed
+// by a 0 byte.
+void MappedFileTest() {
+  std::string loaded;
+  TEST_EQ(flatbuffers::LoadFile("tests/monster_test.fbs", true, &loaded), true);
+  flatbuffers::MappedFile mapped;
+  TEST_EQ(mapped.Open("tests/monster_test.fbs"), true);
+  TEST_EQ(mapped.size(), loaded.size());
+  TEST_EQ(memcmp(mapped.data(), loaded.data(), loaded.size()), 0);
+  TEST_EQ(mapped.data()[mapped.size()], '\0');
+
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(mapped.data(), include_directories), true);
+
+  // A size that is likely a whole number of pages.
+  const char *name = "tests/mapped_file_test.tmp";
+  std::string pages(1 << 16, 'x');
+  TEST_EQ(flatbuffers::SaveFile(name, pages, true), true);
+  TEST_EQ(mapped.Open(name), true);
+  TEST_EQ(mapped.size(), pages.size());
+  TEST_EQ(mapped.data()[mapped.size() - 1], 'x');
+  TEST_EQ(mapped.data()[mapped.size()], '\0');
+  mapped.Close();
+  remove(name);
+
+  TEST_EQ(mapped.Open("tests/does_not_exist"), false);
+}
+
+// Parse a schema that includes a tree of many others, each of which should
+// only be read once no matter how many include statements precede it.
+void IncludeTreeTest() {
+  const int num_files = 500;
+  // Generated into a directory of their own under the system's temporary
+  // directory (named after this process, so tests can run concurrently),
+  // which is removed again afterwards.
+  const char *tmp = getenv("TMPDIR");
+  if (!tmp) tmp = getenv("TEMP");
+  #ifdef _WIN32
+    if (!tmp) tmp = ".";
+  #else
+    if (!tmp) tmp = "/tmp";
+  #endif
+  auto dir = flatbuffers::ConCatPathFileName(
+               tmp, "flatbuffers_include_tree_" +
+                    flatbuffers::NumToString(static_cast<int>(getpid())));
+  flatbuffers::EnsureDirExists(dir);
+  auto file_name = [](int i) {
+    return "include_tree_test_" + flatbuffers::NumToString(i) + ".fbs";
+  };
+  auto file_path = [&](int i) {
+    return flatbuffers::ConCatPathFileName(dir, file_name(i));
+  };
+  // The root includes all other files in order, and each of those includes
+  // its predecessor, which has therefore always been parsed already.
+  for (int i = 0; i < num_files; i++) {
+    std::string schema;
+    if (i == 0) {
+      for (int j = 1; j < num_files; j++)
+        schema += "include \"" + file_name(j) + "\";\n";
+    } else if (i > 1) {
+      schema += "include \"" + file_name(i - 1) + "\";\n";
+    }
+    auto last = flatbuffers::NumToString(i ? i - 1 : num_files - 1);
+    schema += "table T" + flatbuffers::NumToString(i) + " { a:int; ";
+    if (i != 1) schema += "b:T" + last + "; ";
+    schema += "}\n";
+    TEST_EQ(flatbuffers::SaveFile(file_path(i).c_str(), schema, false), true);
+  }
+
+  flatbuffers::MappedFile root;
+  TEST_EQ(root.Open(file_path(0).c_str()), true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { dir.c_str(), nullptr };
+  TEST_EQ(parser.Parse(root.data(), include_directories,
+                       file_path(0).c_str()), true);
+  TEST_EQ(parser.structs_.vec.size(), static_cast<size_t>(num_files));
+  TEST_EQ(parser.included_files_.size(), static_cast<size_t>(num_files));
+  for (int i = 0; i < num_files; i++) {
+    auto def = parser.structs_.Lookup("T" + flatbuffers::NumToString(i));
+    TEST_NOTNULL(def);
+    if (def) TEST_EQ(def->generated, i != 0);
+  }
+  root.Close();
+  for (int i = 0; i < num_files; i++) remove(file_path(i).c_str());
+  #ifdef _WIN32
+    _rmdir(dir.c_str());
+  #else
+    rmdir(dir.c_str());
+  #endif
+}
+
 // High level stress/fuzz test: generate a big schema and
 // matching json data in random combinations, then parse both,
 // generate json back from the binary, and compare with the original.
@@ -536,6 +1259,7 @@ void ErrorTest() {
   TestError(".0", "floating point");
   TestError("\"\0", "illegal");
   TestError("\"\\q", "escape code");
+  TestError("\"abc\ndef\"", "illegal");
   TestError("table ///", "documentation");
   TestError("@", "illegal");
   TestError("table 1", "expecting");
@@ -557,6 +1281,12 @@ void ErrorTest() {
             "{ V:{ Y:1 } }", "incomplete");
   TestError("enum E:byte { A } table X { Y:E; } root_type X; { Y:U }",
             "unknown enum value");
+  TestError("enum E:byte { A } table X { Y:E; } root_type X; { Y:\"A U\" }",
+            "unknown enum value: U,");
+  TestError("enum E:byte { A } table X { Y:int; } root_type X; { Y:\"F.A\" }",
+            "unknown enum: F");
+  TestError("enum E:byte { A } table X { Y:int; } root_type X; { Y:\"A\" }",
+            "qualified");
   TestError("table X { Y:byte; } root_type X; { Y:; }", "starting");
   TestError("enum X:byte { Y } enum X {", "enum already");
   TestError("enum X:float {}", "underlying");
@@ -592,6 +1322,48 @@ void ScientificTest() {
           fabs(root[1] - 3.14159) < 0.001, true);
 }
 
+template<typename T> std::string CharsOf(T val) {
+  char buf[flatbuffers::kMaxNumChars];
+  return std::string(buf, flatbuffers::NumToChars(val, buf));
+}
+
+// Integers must come out exactly as NumToString() writes them, and floating
+// point values must read back exactly, while keeping NumToString()'s text
+// where that was already exact.
+void NumToCharsTest() {
+  TEST_EQ(CharsOf<int8_t>(-128), "-128");
+  TEST_EQ(CharsOf<uint8_t>(255), "255");
+  TEST_EQ(CharsOf<int32_t>(0), "0");
+  TEST_EQ(CharsOf<int64_t>(std::numeric_limits<int64_t>::min()),
+          flatbuffers::NumToString(std::numeric_limits<int64_t>::min()));
+  TEST_EQ(CharsOf<uint64_t>(std::numeric_limits<uint64_t>::max()),
+          "18446744073709551615");
+  lcg_reset();
+  for (int i = 0; i < 10000; i++) {
+    auto v = static_cast<int32_t>(lcg_rand()) >> (i % 31);
+    TEST_EQ(CharsOf(v), flatbuffers::NumToString(v));
+  }
+
+  TEST_EQ(CharsOf(3.14159f), "3.14159");
+  TEST_EQ(CharsOf(0.1), "0.1");
+  TEST_EQ(CharsOf(-0.0), "-0");
+  TEST_EQ(CharsOf(1e6f), "1e+06");
+  TEST_EQ(CharsOf(1234567.0f), "1234567");
+  TEST_EQ(CharsOf(1.0 / 3), "0.3333333333333333");
+  TEST_EQ(CharsOf(1.0f / 3), "0.33333334");
+  TEST_EQ(CharsOf(0.1 + 0.2), "0.30000000000000004");
+  for (int i = 0; i < 10000; i++) {
+    uint32_t f_bits = lcg_rand();
+    uint64_t d_bits = (static_cast<uint64_t>(lcg_rand()) << 32) | lcg_rand();
+    float f;
+    double d;
+    memcpy(&f, &f_bits, sizeof(f));
+    memcpy(&d, &d_bits, sizeof(d));
+    if (f == f) TEST_EQ(strtof(CharsOf(f).c_str(), nullptr), f);
+    if (d == d) TEST_EQ(strtod(CharsOf(d).c_str(), nullptr), d);
+  }
+}
+
 void EnumStringsTest() {
   flatbuffers::Parser parser1;
   TEST_EQ(parser1.Parse("enum E:byte { A, B, C } table T { F:[E]; }"
@@ -603,6 +1375,291 @@ void EnumStringsTest() {
                         "{ F:[ \"E.C\", \"E.A E.B E.C\" ] }"), true);
 }
 
+void SymbolTableTest() {
+  flatbuffers::SymbolTable<int> table;
+  for (int i = 0; i < 100; i++) {
+    TEST_EQ(table.Add("f" + flatbuffers::NumToString(i), new int(i)), false);
+  }
+  // Duplicates are kept in order, but lookups find the first one.
+  TEST_EQ(table.Add("f7", new int(-7)), true);
+  TEST_EQ(table.vec.size(), 101U);
+  TEST_EQ(*table.Lookup("f7"), 7);
+  TEST_EQ(*table.Lookup(std::string("f99")), 99);
+  TEST_EQ(*table.Lookup("f10 trailing", 3), 10);
+  TEST_EQ(*table.Lookup("f10", 2), 1);
+  TEST_EQ(table.Lookup("f100") == nullptr, true);
+  TEST_EQ(table.Lookup("") == nullptr, true);
+
+  // A wide table, whose fields are all looked up by name from the json.
+  const int num_fields = 300;
+  std::string schema = "table T {";
+  std::string json = "{";
+  for (int i = 0; i < num_fields; i++) {
+    auto num = flatbuffers::NumToString(i);
+    schema += " f" + num + ":int;";
+    json += (i ? ", f" : " f") + num + ": " + flatbuffers::NumToString(i + 1);
+  }
+  schema += " } root_type T;";
+  json += " }";
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(schema.c_str()), true);
+  TEST_EQ(parser.Parse(json.c_str()), true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                parser.builder_.GetBufferPointer());
+  for (int i = 0; i < num_fields; i++) {
+    TEST_EQ(root->GetField<int32_t>(
+              static_cast<flatbuffers::voffset_t>(4 + i * 2), 0), i + 1);
+  }
+}
+
+// Identifiers that merely resemble keywords must stay identifiers.
+void KeywordTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table tables { int8:int; Bool:bool = true; "
+                       "falsey:bool; doubles:[double]; }"
+                       "root_type tables;"
+                       "{ int8: 3, Bool: false, falsey: true, "
+                       "doubles: [1.5] }"), true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                parser.builder_.GetBufferPointer());
+  TEST_EQ(root->GetField<int32_t>(4, 0), 3);
+  TEST_EQ(root->GetField<uint8_t>(6, 1), 0);
+  TEST_EQ(root->GetField<uint8_t>(8, 0), 1);
+}
+
+// Strings mixing plain runs, escape codes and UTF-8 should come out intact.
+void StringConstantTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { F:string; } root_type T;"
+                       "{ F: \"plain \\\"quoted\\\" tab\\t"
+                       "slash\\/ \xC3\xA9\\\\\" }"), true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                parser.builder_.GetBufferPointer());
+  auto str = root->GetPointer<const flatbuffers::String *>(4);
+  TEST_EQ(strcmp(str->c_str(), "plain \"quoted\" tab\tslash/ \xC3\xA9\\"), 0);
+}
+
+// Values and defaults of all kinds should survive parsing into typed values.
+void TypedValueTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("enum E:short { A = -2, B = 7 }"
+                       "table T { a:ulong; b:float = 2; c:E = B; d:bool = true;"
+                       " e:double; f:byte = -128; }"
+                       "root_type T;"
+                       "{ a: 18446744073709551615, b: 3, e: -0.25 }"), true);
+  // Defaults are still available as text, for the code generators.
+  auto fields = parser.root_struct_def->fields.vec;
+  TEST_EQ(fields[2]->value.constant, std::string("7"));
+  TEST_EQ(fields[3]->value.constant, std::string("1"));
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                parser.builder_.GetBufferPointer());
+  TEST_EQ(root->GetField<uint64_t>(4, 0), 18446744073709551615ULL);
+  TEST_EQ(root->GetField<float>(6, 2), 3.0f);
+  TEST_EQ(root->GetField<int16_t>(8, 7), 7);
+  TEST_EQ(root->GetField<uint8_t>(10, 1), 1);
+  TEST_EQ(root->GetField<double>(12, 0), -0.25);
+  TEST_EQ(root->CheckField(14), false);  // Default of -128 not stored.
+}
+
+void FieldOrderTest() {
+  // Inline fields are serialized in an order planned from the schema, so the
+  // order they appear in the JSON must not affect the resulting buffer.
+  const char *schema = "struct S { a:byte; b:int; }"
+                       "table T { a:byte; b:double; c:S; d:string; e:short; }"
+                       "root_type T;";
+  flatbuffers::Parser parser1;
+  TEST_EQ(parser1.Parse(schema), true);
+  TEST_EQ(parser1.Parse("{ a: 1, b: 2, c: { a: 3, b: 4 }, e: 5 }"), true);
+  flatbuffers::Parser parser2;
+  TEST_EQ(parser2.Parse(schema), true);
+  TEST_EQ(parser2.Parse("{ e: 5, c: { a: 3, b: 4 }, b: 2, a: 1 }"), true);
+  TEST_EQ(parser1.builder_.GetSize(), parser2.builder_.GetSize());
+  TEST_EQ(memcmp(parser1.builder_.GetBufferPointer(),
+                 parser2.builder_.GetBufferPointer(),
+                 parser1.builder_.GetSize()), 0);
+  // Out of line values are still found, whichever order they come in.
+  flatbuffers::Parser parser3;
+  TEST_EQ(parser3.Parse(schema), true);
+  TEST_EQ(parser3.Parse("{ d: \"x\", e: 5, c: { a: 3, b: 4 }, a: 1 }"), true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+                parser3.builder_.GetBufferPointer());
+  TEST_EQ(root->GetField<int8_t>(4, 0), 1);
+  TEST_EQ(root->CheckField(6), false);
+  TEST_EQ(root->GetStruct<const int8_t *>(8)[0], 3);
+  TEST_EQ(root->GetPointer<const flatbuffers::String *>(10)->c_str(),
+          std::string("x"));
+  TEST_EQ(root->GetField<int16_t>(12, 0), 5);
+}
+
+// A schema loaded from its binary form should parse and generate JSON the
+// same as the schema it was made from.
+void BinarySchemaTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  const char *include_directories[] = { "tests", nullptr };
+  flatbuffers::Parser text_parser;
+  TEST_EQ(text_parser.Parse(schemafile.c_str(), include_directories), true);
+  flatbuffers::FlatBufferBuilder schema;
+  text_parser.Serialize(schema);
+
+  flatbuffers::Parser binary_parser;
+  TEST_EQ(binary_parser.Deserialize(schema.GetBufferPointer(),
+                                    schema.GetSize()), true);
+  TEST_EQ(binary_parser.file_identifier_, std::string("MONS"));
+  TEST_EQ(binary_parser.file_extension_, std::string("mon"));
+  // Serializing it again gives the same binary schema.
+  flatbuffers::FlatBufferBuilder schema2;
+  binary_parser.Serialize(schema2);
+  TEST_EQ(schema2.GetSize(), schema.GetSize());
+  TEST_EQ(memcmp(schema2.GetBufferPointer(), schema.GetBufferPointer(),
+                 schema.GetSize()), 0);
+
+  TEST_EQ(text_parser.Parse(jsonfile.c_str(), include_directories), true);
+  TEST_EQ(binary_parser.Parse(jsonfile.c_str()), true);
+  TEST_EQ(binary_parser.builder_.GetSize(), text_parser.builder_.GetSize());
+  TEST_EQ(memcmp(binary_parser.builder_.GetBufferPointer(),
+                 text_parser.builder_.GetBufferPointer(),
+                 text_parser.builder_.GetSize()), 0);
+  flatbuffers::GeneratorOptions opts;
+  std::string text_json, binary_json;
+  GenerateText(text_parser, text_parser.builder_.GetBufferPointer(), opts,
+               &text_json);
+  GenerateText(binary_parser, binary_parser.builder_.GetBufferPointer(), opts,
+               &binary_json);
+  TEST_EQ(binary_json, text_json);
+
+  // Attributes keep the order they were declared in.
+  flatbuffers::Parser attr_parser;
+  TEST_EQ(attr_parser.Parse("attribute \"zz\"; attribute \"aa\";"
+                            "table T { f:int (zz, aa: \"x\"); }"), true);
+  flatbuffers::FlatBufferBuilder attr_schema;
+  attr_parser.Serialize(attr_schema);
+  auto attrs = reflection::GetSchema(attr_schema.GetBufferPointer())->
+                 objects()->Get(0)->fields()->Get(0)->attributes();
+  TEST_EQ(attrs->size(), 2U);
+  TEST_EQ(attrs->Get(0)->key()->str(), "zz");
+  TEST_EQ(attrs->Get(1)->key()->str(), "aa");
+  TEST_EQ(attrs->Get(1)->value()->str(), "x");
+  flatbuffers::Parser attr_binary_parser;
+  TEST_EQ(attr_binary_parser.Deserialize(attr_schema.GetBufferPointer(),
+                                         attr_schema.GetSize()), true);
+  auto &field_attrs = attr_binary_parser.structs_.Lookup("T")->fields.
+                        Lookup("f")->attributes;
+  TEST_EQ(field_attrs.vec.size(), 2U);
+  TEST_EQ(field_attrs.vec[0] == field_attrs.Lookup("zz"), true);
+  TEST_EQ(field_attrs.vec[1] == field_attrs.Lookup("aa"), true);
+
+  // A struct layout that doesn't add up is rejected, since parsing JSON
+  // against it would write outside the struct.
+  auto corrupt_vec3 = [&](flatbuffers::voffset_t field, int32_t value,
+                          bool last_field) {
+    std::vector<uint8_t> bfbs(schema.GetBufferPointer(),
+                              schema.GetBufferPointer() + schema.GetSize());
+    auto objects = reflection::GetSchema(&bfbs[0])->objects();
+    for (auto it = objects->begin(); it != objects->end(); ++it) {
+      if (it->name()->str() != "Vec3") continue;
+      if (last_field) {  // A field's offset is a uint16_t.
+        auto table = reinterpret_cast<const flatbuffers::Table *>(
+                       it->fields()->Get(it->fields()->size() - 1));
+        const_cast<flatbuffers::Table *>(table)->SetField(
+          field, static_cast<uint16_t>(value));
+      } else {  // An object's minalign and bytesize are int32_t.
+        auto table = reinterpret_cast<const flatbuffers::Table *>(*it);
+        const_cast<flatbuffers::Table *>(table)->SetField(field, value);
+      }
+    }
+    flatbuffers::Parser parser;
+    return parser.Deserialize(&bfbs[0], bfbs.size());
+  };
+  TEST_EQ(corrupt_vec3(18 /* bytesize */, 31, false), false);
+  TEST_EQ(corrupt_vec3(18 /* bytesize */, 48, false), false);
+  TEST_EQ(corrupt_vec3(16 /* minalign */, 3, false), false);
+  TEST_EQ(corrupt_vec3(16 /* minalign */, 512, false), false);
+  TEST_EQ(corrupt_vec3(8 /* offset */, 31, true), false);
+  TEST_EQ(corrupt_vec3(18 /* bytesize */, 32, false), true);
+
+  // Anything else is rejected, with an error in the usual format.
+  flatbuffers::Parser bad_parser;
+  TEST_EQ(bad_parser.Deserialize(
+            reinterpret_cast<const uint8_t *>(schemafile.c_str()),
+            schemafile.size(), "tests/monster_test.fbs"), false);
+  TEST_EQ(bad_parser.error_.find("monster_test.fbs:0:0: error: ") !=
+          std::string::npos || bad_parser.error_.find(
+            "monster_test.fbs(0): error: ") != std::string::npos, true);
+}
+
+// Parsers sharing a schema should give the same results as the one that
+// parsed it, also when used concurrently.
+void SharedSchemaTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  const char *include_directories[] = { "tests", nullptr };
+  flatbuffers::Parser schema;
+  TEST_EQ(schema.Parse(schemafile.c_str(), include_directories), true);
+  flatbuffers::Parser reference(schema, false);
+  TEST_EQ(reference.Parse(jsonfile.c_str()), true);
+  std::string expected(
+    reinterpret_cast<const char *>(reference.builder_.GetBufferPointer()),
+    reference.builder_.GetSize());
+
+  const int num_threads = 4;
+  int mismatches[num_threads] = { 0 };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.push_back(std::thread([&, t]() {
+      flatbuffers::Parser parser(schema, false);
+      for (int i = 0; i < 100; i++) {
+        if (!parser.Parse(jsonfile.c_str()) ||
+            expected != std::string(reinterpret_cast<const char *>(
+                                      parser.builder_.GetBufferPointer()),
+                                    parser.builder_.GetSize()))
+          mismatches[t]++;
+      }
+    }));
+  }
+  for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+  for (int t = 0; t < num_threads; t++) TEST_EQ(mismatches[t], 0);
+
+  // Qualified enum values are looked up in the shared schema, which can't
+  // be extended through them.
+  flatbuffers::Parser enum_schema;
+  TEST_EQ(enum_schema.Parse("enum E:int { A, B } table T { i:int; }"
+                            "root_type T;"), true);
+  flatbuffers::Parser parser(enum_schema, false);
+  TEST_EQ(parser.Parse("{ i: \"E.B\" }"), true);
+  TEST_EQ(flatbuffers::GetRoot<flatbuffers::Table>(
+            parser.builder_.GetBufferPointer())->GetField<int32_t>(4, 0), 1);
+  TEST_EQ(parser.Parse("table X { a:int; }"), false);
+
+  // The root type is looked up in the shared schema too, and can be changed
+  // without affecting it.
+  flatbuffers::Parser root_schema;
+  TEST_EQ(root_schema.Parse("table A { a:int; } table B { b:short; }"
+                            "root_type A;"), true);
+  flatbuffers::Parser sharing(root_schema, false);
+  TEST_EQ(sharing.SetRootType("B"), true);
+  TEST_EQ(sharing.root_struct_def->name, std::string("B"));
+  TEST_EQ(sharing.SetRootType("C"), false);
+  TEST_EQ(sharing.Parse("root_type B; { b: 7 }"), true);
+  TEST_EQ(flatbuffers::GetRoot<flatbuffers::Table>(
+            sharing.builder_.GetBufferPointer())->GetField<int16_t>(4, 0), 7);
+  TEST_EQ(sharing.Parse("root_type C; { b: 7 }"), false);
+  TEST_EQ(root_schema.root_struct_def->name, std::string("A"));
+
+  // Code generation and Serialize() are given the parser holding the
+  // definitions.
+  TEST_EQ(&sharing.GetSchema() == &root_schema, true);
+  TEST_EQ(&root_schema.GetSchema() == &root_schema, true);
+}
+
 void UnicodeTest() {
   flatbuffers::Parser parser;
   TEST_EQ(parser.Parse("table T { F:string; }"
@@ -615,6 +1672,35 @@ void UnicodeTest() {
   GenerateText(parser, parser.builder_.GetBufferPointer(), opts, &jsongen);
   TEST_EQ(jsongen == "{F: \"\\u20AC\\u00A2\\u30E6\\u30FC\\u30B6\\u30FC"
                      "\\u5225\\u30B5\\u30A4\\u30C8\\x01\\x80\"}", true);
+
+  // Long strings are scanned many bytes at a time, so escapes must be found
+  // at any position, and the text must read back as the original bytes.
+  const char *specials[] = { "\"", "\\", "\n", "\t", "\x01", "\x7F",
+                             "\xC3\xA9", "\xE2\x82\xAC", "\xFF" };
+  const int num_specials = sizeof(specials) / sizeof(specials[0]);
+  lcg_reset();
+  for (int i = 0; i < 200; i++) {
+    std::string str;
+    auto len = lcg_rand() % 100;
+    for (uint32_t j = 0; j < len; j++) {
+      if (lcg_rand() % 8) str += static_cast<char>(' ' + lcg_rand() % 95);
+      else str += specials[lcg_rand() % num_specials];
+    }
+    flatbuffers::Parser in(parser, false);
+    in.builder_.Clear();
+    auto root = in.builder_.StartTable();
+    in.builder_.AddOffset(4, in.builder_.CreateString(str));
+    in.builder_.Finish(flatbuffers::Offset<flatbuffers::Table>(
+                         in.builder_.EndTable(root, 1)));
+    std::string json;
+    GenerateText(in, in.builder_.GetBufferPointer(), opts, &json);
+    flatbuffers::Parser out(parser, false);
+    TEST_EQ(out.Parse(json.c_str()), true);
+    auto table = flatbuffers::GetRoot<flatbuffers::Table>(
+                   out.builder_.GetBufferPointer());
+    TEST_EQ(table->GetPointer<const flatbuffers::String *>(4)->str() == str,
+            true);
+  }
 }
 
 int main(int /*argc*/, const char * /*argv*/[]) {
@@ -628,15 +1714,38 @@ int main(int /*argc*/, const char * /*argv*/[]) {
 
   #ifndef __ANDROID__  // requires file access
   ParseAndGenerateTextTest();
+  ParallelTextTest();
   ParseProtoTest();
   #endif
 
   FuzzTest1();
   FuzzTest2();
 
+  VTableDedupTest();
+  VerifyTableFieldsTest();
+  ParallelVerifyTest();
+  MemoizeTablesTest();
+  SharedStringTest();
+  PoolAllocatorTest();
+  ChunkedStorageTest();
+  ReserveTest();
+  ScalarVectorTest();
+  SizePrefixedTest();
+  JsonStreamTest();
+  MappedFileTest();
+  IncludeTreeTest();
+
   ErrorTest();
   ScientificTest();
+  NumToCharsTest();
   EnumStringsTest();
+  SymbolTableTest();
+  KeywordTest();
+  StringConstantTest();
+  TypedValueTest();
+  FieldOrderTest();
+  BinarySchemaTest();
+  SharedSchemaTest();
   UnicodeTest();
 
   if (!testing_fails) {